@@ -0,0 +1,241 @@
+#include "puzzle_sets.h"
+
+#include "grid.h"
+#include "solver.h"
+#include "bitmask_solver.h"
+#include "dlx_solver.h"
+#include "band_solver.h"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace
+{
+    using clock = std::chrono::steady_clock;
+
+    struct Sample
+    {
+        int64_t ns = 0;
+        int64_t steps = 0;
+        bool solved = false;
+        SolverStats stats;
+    };
+
+    template <typename S, typename... Args>
+    Sample solve(Grid& grid, Args... args)
+    {
+        const auto start = clock::now();
+
+        S solver(grid, args...);
+        while (!solver.is_solved() && !solver.is_unsolvable())
+            solver.solve_step();
+
+        const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - start);
+        return {elapsed.count(), solver.solve_steps_, solver.is_solved(), solver.stats_};
+    }
+
+    struct EngineEntry
+    {
+        std::string_view name;
+        Sample (*run)(Grid& grid);
+    };
+
+    constexpr BitmaskSolver::Options mrv{.selection = BitmaskSolver::Selection::mrv};
+    constexpr BitmaskSolver::Options mrv_propagate{.selection = BitmaskSolver::Selection::mrv, .propagate = true};
+
+    constexpr EngineEntry engines[] =
+    {
+        {"backtrack", [](Grid& grid) { return solve<Solver>(grid); }},
+        {"bitmask", [](Grid& grid) { return solve<BitmaskSolver>(grid); }},
+        {"bitmask-mrv", [](Grid& grid) { return solve<BitmaskSolver>(grid, mrv); }},
+        {"bitmask-mrv-propagate", [](Grid& grid) { return solve<BitmaskSolver>(grid, mrv_propagate); }},
+        {"dlx", [](Grid& grid) { return solve<DlxSolver>(grid); }},
+        {"bands", [](Grid& grid) { return solve<BandSolver>(grid); }},
+    };
+
+    struct Result
+    {
+        std::string_view engine;
+        std::string_view set;
+        int64_t puzzles = 0;
+        int64_t unsolved = 0;
+        bool complete = true; // false when the time budget ran out first
+        std::vector<Sample> samples = {};
+    };
+
+    // every puzzle of the set `repeat` times, stopping early once `budget`
+    // is spent. A puzzle is never cut short, so one slow grid can overrun it.
+    Result run(EngineEntry const& engine, PuzzleSet const& set, int repeat, std::chrono::milliseconds budget)
+    {
+        Result result{.engine = engine.name, .set = set.name};
+        const auto deadline = clock::now() + budget;
+
+        for (std::string_view puzzle : set.puzzles)
+        {
+            if (clock::now() > deadline)
+            {
+                result.complete = false;
+                break;
+            }
+
+            Grid grid;
+            for (int r = 0; r < repeat; ++r)
+            {
+                grid.parse(puzzle);
+                result.samples.push_back(engine.run(grid));
+            }
+
+            result.unsolved += !result.samples.back().solved;
+            ++result.puzzles;
+        }
+
+        return result;
+    }
+
+    double mean(Result const& result, int64_t Sample::*field)
+    {
+        int64_t total = 0;
+        for (Sample const& s : result.samples)
+            total += s.*field;
+
+        return (double)total / (double)std::max<size_t>(result.samples.size(), 1);
+    }
+
+    int64_t percentile(std::vector<int64_t> const& sorted, double p)
+    {
+        if (sorted.empty())
+            return 0;
+
+        const size_t rank = (size_t)(p * (double)(sorted.size() - 1) + 0.5);
+        return sorted[std::min(rank, sorted.size() - 1)];
+    }
+
+    std::string to_json(Result const& result)
+    {
+        std::vector<int64_t> ns;
+        for (Sample const& s : result.samples)
+            ns.push_back(s.ns);
+        std::ranges::sort(ns);
+
+        std::string stats;
+#if SUDOKU_STATS
+        SolverStats total;
+        for (Sample const& s : result.samples)
+            total += s.stats;
+
+        const double count = (double)std::max<size_t>(result.samples.size(), 1);
+        stats = fmt::format(",\n     \"decisions_per_puzzle\": {:.1f}, \"backtracks_per_puzzle\": {:.1f}, "
+                            "\"propagations_per_puzzle\": {:.1f}, \"max_depth\": {}",
+                            total.decisions / count, total.backtracks / count, total.propagations / count, total.max_depth);
+#endif
+
+        return fmt::format(
+            "    {{\"engine\": \"{}\", \"set\": \"{}\", \"puzzles\": {}, \"solves\": {}, \"unsolved\": {}, \"complete\": {},\n"
+            "     \"ns_per_puzzle\": {:.0f}, \"steps_per_puzzle\": {:.1f},\n"
+            "     \"ns_p50\": {}, \"ns_p90\": {}, \"ns_p99\": {}, \"ns_max\": {}{}}}",
+            result.engine, result.set, result.puzzles, result.samples.size(), result.unsolved, result.complete,
+            mean(result, &Sample::ns), mean(result, &Sample::steps),
+            percentile(ns, 0.5), percentile(ns, 0.9), percentile(ns, 0.99), ns.empty() ? 0 : ns.back(), stats);
+    }
+
+    template <typename T>
+    bool parse_number(std::string_view text, T& value)
+    {
+        return std::from_chars(text.data(), text.data() + text.size(), value).ec == std::errc{};
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    constexpr auto usage =
+        "usage: {} [--engine <name>]... [--set <name>]... [--repeat <n>] [--budget <ms>] [--output <file>]\n"
+        "engines: backtrack bitmask bitmask-mrv bitmask-mrv-propagate dlx bands\n"
+        "sets: easy hard 17-clue pathological\n";
+
+    std::vector<std::string_view> engine_names, set_names;
+    std::string_view output;
+    int repeat = 3;
+    int64_t budget_ms = 2000;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string_view arg = argv[i];
+        std::string_view value = (i + 1 < argc) ? argv[i + 1] : "";
+        bool valid = true;
+
+        if (arg == "--engine")
+        {
+            valid = std::ranges::any_of(engines, [&](EngineEntry const& e) { return e.name == value; });
+            engine_names.push_back(value);
+        }
+        else if (arg == "--set")
+        {
+            valid = std::ranges::any_of(puzzle_sets(), [&](PuzzleSet const& s) { return s.name == value; });
+            set_names.push_back(value);
+        }
+        else if (arg == "--repeat")
+            valid = parse_number(value, repeat) && repeat > 0;
+        else if (arg == "--budget")
+            valid = parse_number(value, budget_ms) && budget_ms > 0;
+        else if (arg == "--output")
+            valid = !(output = value).empty();
+        else
+            valid = false;
+
+        if (!valid)
+        {
+            fmt::print(stderr, usage, argv[0]);
+            return 2;
+        }
+
+        ++i;
+    }
+
+    auto selected = [](auto const& names, std::string_view name)
+    {
+        return names.empty() || std::ranges::find(names, name) != names.end();
+    };
+
+    std::vector<std::string> entries;
+    for (EngineEntry const& engine : engines)
+    {
+        if (!selected(engine_names, engine.name))
+            continue;
+
+        for (PuzzleSet const& set : puzzle_sets())
+        {
+            if (!selected(set_names, set.name))
+                continue;
+
+            const Result result = run(engine, set, repeat, std::chrono::milliseconds(budget_ms));
+            fmt::print(stderr, "{:<22} {:<13} {:>12.0f} ns/puzzle{}\n", engine.name, set.name, mean(result, &Sample::ns),
+                       result.complete ? "" : " (budget spent)");
+            entries.push_back(to_json(result));
+        }
+    }
+
+    std::string json = fmt::format("{{\n  \"repeat\": {},\n  \"budget_ms\": {},\n  \"results\": [\n", repeat, budget_ms);
+    for (size_t i = 0; i < entries.size(); ++i)
+        json += entries[i] + (i + 1 < entries.size() ? ",\n" : "\n");
+    json += "  ]\n}\n";
+
+    std::FILE* file = output.empty() ? stdout : std::fopen(std::string(output).c_str(), "wb");
+    if (file == nullptr)
+    {
+        fmt::print(stderr, "can not open '{}'\n", output);
+        return 1;
+    }
+
+    fmt::print(file, "{}", json);
+    if (file != stdout)
+        std::fclose(file);
+
+    return 0;
+}
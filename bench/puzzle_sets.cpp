@@ -0,0 +1,100 @@
+#include "puzzle_sets.h"
+
+namespace
+{
+    // minimal generated puzzles that naked and hidden singles solve alone.
+    constexpr std::string_view easy[] =
+    {
+        "...........61.....8...4...64.86.9..12...85....9........3...245.9......2..2.9..13.",
+        "..........8.3.1.....985.73..4....326...7....42.8...9..57............5..2..4678...",
+        ".........67.2....5.1.....6.........9.573.9..43..5.4..2...973.8..9.4......6..2..4.",
+        "........55.9...1.8..6.1..472..8..7..6.....3....76....11.3..45......8....4.876...3",
+        "........9..5..94...2.7....6.....43....25....74.....691.4.1........6...821...7....",
+        ".......4.94..7...58..3....1..67.83..2....6.9..........695..3...7......5.....8...2",
+        ".......682.6.......71...45.....1.2.....2.6......7...35.3.962..1.1.......5....86.9",
+        ".......76..2....8...1657..43...84..........25..8...4.......539.6..7........19...2",
+        "......74.1..7..9.8.6...9...4..3.....8...45.1..91....7.7.5....9.........1.3..6..2.",
+        "......79..382.5...7..43.......3.4.......5.9..2..1..3..........414.......59....26.",
+        "......8...3524..1.6..9..4.......1..6..73.4..2...5....4..8...3...1.85..7...31.....",
+        ".....1...26......84..59..2..4...3........217.1856.......1.4...3......79..98......",
+        ".....1...48......6.1..7635.2...........9..7...7.358...348...1.....6.2.....5....4.",
+        ".....29365..6.3..8.1.......7....6....2.4..361...8...5.934...8........29......4...",
+        ".....31..6..2..4.....4..9..9.4...5.........7.1..95..6....5.7.8..29.......7...2...",
+        ".....4...........723859.....82.....5....6......74..68.3...7.......6...535...4..69",
+        ".....4..6..328.1...94..5..........8153........6..4.5.3.5..9...2.497.2..........9.",
+        ".....759....2..1......6..7..28.4....1.5..6.4....9...6...68....5...3.9...73.......",
+        "....1..482..87.19...9..2............4.6........2143....9......7.....15..8.39.5...",
+        "....2...............1..8.74..3.1....28.3....9...7.42..8.....4...4....631.6..5..92",
+        "....2..........4..5...68.7........1....21...3..6..9.4...3.5.2..9214....6.7.....9.",
+        "....2.......8.54.9..1.......286.95.....5......5.4....2.......46.6..8....1.79...3.",
+        "....4...9.9....1.86..1.873.38.9..........5.26...73.....62....5...........38.76.9.",
+        "....45.7..2...1...3.7....65....8...2..8.....393.5..6......7.....1.9...8.29.......",
+    };
+
+    // well known hard puzzles, then the generated ones needing the most guesses.
+    constexpr std::string_view hard[] =
+    {
+        "1.......2.9.4...5...6...7...5.9.3.......7.......85..4.7.....6...3...9.8...2.....1",
+        "8..........36......7..9.2...5...7.......457.....1...3...1....68..85...1..9....4..",
+        "85...24..72......9..4.........1.7..23.5...9...4...........8..7..17..........36.4.",
+        "..53.....8......2..7..1.5..4....53...1..7...6..32...8..6.5....9..4....3......97..",
+        "12.3....435....1....4........54..2..6...7.........8.9...31..5.......9.7.....6...8",
+        "4.....8.5.3..........7......2.....6.....8.4......1.......6.3.7.5..2.....1.4......",
+        "6..1......3....5.......8.24.53.....9....4.8..9....734...7639..........1.3.8.2....",
+        "8.4.291....273.........1.5.......8..2......9..6.3.4.....39.6.4..294..7..4......8.",
+        "2..1...763.58.........425...8.........7...9......8.64..3..9...4.7..3.....2.6....1",
+        "7.8...5.....89.......4.62....2.....7.3....814........56...3.7..9.......287...1.63",
+        "2.3...4...65..9........826.....51..9..4.2.....9....1....74............1.4.2...3..",
+        "987.....6....5.97..5......1..............3728.7..984....4...6....29..1..89..2....",
+        "..48..5.93..........6.....87...2...1.....5...569....7.19.5..3.....3.4.......9..12",
+        "9..27..8...15....7.84.....9.9....5..3....78.4........6.139.5.......4.......78...1",
+        ".736...4.8...93..14...5.......7...6..2....8....19.6...2.5.7....74.2...1......1...",
+        "...3..2.......2..4..9..5.7....6......6..3.8.7.7...9..161.9......54....16..216..8.",
+    };
+
+    // puzzles with 17 givens, the fewest a unique puzzle can have, and
+    // relabelled and permuted copies of them.
+    constexpr std::string_view seventeen[] =
+    {
+        ".......1.4.........2...........5.4.7..8...3....1.9....3..4..2...5.1........8.6...",
+        ".......1.4.........2...........5.6.4..8...3....1.9....3..4..2...5.1........8.7...",
+        ".......12....35......6...7.7.....3.....4..8..1...........12.....8.....4..5....6..",
+        ".......12..36..........7...41..2.......5..3..7.....6..28.....4....3..5...........",
+        ".......12..8.3...........4.12.5..........47...6.......5.7...3.....62.......1.....",
+        "..............3.85..1.2.......5.7.....4...1...9.......5......73..2.1........4...9",
+        "4.....8.5.3..........7......2.....6.....8.4......1.......6.3.7.5..2.....1.4......",
+        ".8........94..........1..32......9..6...3.....2....4.8...4.8........6.....1....5.",
+        "....79...2...5....4.1.....6...1.....6............9.35..3....9.....2....4.7.......",
+        "...9.4.....3....7...5...1.......73..8.....2..4...........25.........1.8........49",
+        "...6....8......7.5..2.4...99.3....6......8.1...4..5....8...........9.......2.....",
+        ".7..1............66.....2.52........9....6.......3..8...8...13........7....5.9...",
+        ".17..5.....2....4.......68.........1...34..6...5......3..6..........7..28........",
+        "..8.53...4......9......8.....5........7.....8...1...6.......3.7...4......1.69....",
+        "....8...45.9.........3...1.......539......2...47.......6.......13.....8......9...",
+        "...3..8..46............52...12......5..7........46....3....8........1.7........4.",
+    };
+
+    // puzzles taking millions of steps to a search filling cells in index
+    // order, led by the one built against brute force.
+    constexpr std::string_view pathological[] =
+    {
+        "..............3.85..1.2.......5.7.....4...1...9.......5......73..2.1........4...9",
+        ".......1.4.........2...........5.4.7..8...3....1.9....3..4..2...5.1........8.6...",
+        ".......1.4.........2...........5.6.4..8...3....1.9....3..4..2...5.1........8.7...",
+        "4.....8.5.3..........7......2.....6.....8.4......1.......6.3.7.5..2.....1.4......",
+        ".......12....35......6...7.7.....3.....4..8..1...........12.....8.....4..5....6..",
+    };
+
+    constexpr PuzzleSet sets[] =
+    {
+        {"easy", easy},
+        {"hard", hard},
+        {"17-clue", seventeen},
+        {"pathological", pathological},
+    };
+}
+
+std::span<const PuzzleSet> puzzle_sets()
+{
+    return sets;
+}
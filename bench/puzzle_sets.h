@@ -0,0 +1,14 @@
+#pragma once
+
+#include <span>
+#include <string_view>
+
+// A named list of 81-character puzzles, '.' for blanks, built into the
+// benchmark so runs on different machines solve the same grids.
+struct PuzzleSet
+{
+    std::string_view name;
+    std::span<const std::string_view> puzzles;
+};
+
+std::span<const PuzzleSet> puzzle_sets();
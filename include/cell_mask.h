@@ -0,0 +1,90 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstdint>
+
+// Fixed size set of cell indexes, one bit per cell in 64 bit words, so
+// finding the next or previous member is a count of trailing or leading
+// zeros per word.
+template <int Count>
+class CellMask
+{
+public:
+    static constexpr int word_count = (Count + 63) / 64;
+
+    constexpr void set(int idx) { words_[idx / 64] |= bit(idx); }
+    constexpr void reset(int idx) { words_[idx / 64] &= ~bit(idx); }
+    constexpr bool test(int idx) const { return (words_[idx / 64] & bit(idx)) != 0; }
+
+    constexpr void assign(int idx, bool value)
+    {
+        if (value)
+            set(idx);
+        else
+            reset(idx);
+    }
+
+    constexpr int count() const
+    {
+        int n = 0;
+        for (uint64_t word : words_)
+            n += std::popcount(word);
+        return n;
+    }
+
+    constexpr bool none() const
+    {
+        for (uint64_t word : words_)
+        {
+            if (word != 0)
+                return false;
+        }
+        return true;
+    }
+
+    // first member after `from_idx`, -1 when there is none.
+    constexpr int next(int from_idx) const
+    {
+        int idx = from_idx + 1;
+        if (idx >= Count)
+            return -1;
+
+        int w = idx / 64;
+        uint64_t word = words_[w] & (~uint64_t(0) << (idx % 64));
+        while (word == 0)
+        {
+            if (++w == word_count)
+                return -1;
+            word = words_[w];
+        }
+
+        return w * 64 + std::countr_zero(word);
+    }
+
+    // last member before `from_idx`, -1 when there is none.
+    constexpr int prev(int from_idx) const
+    {
+        if (from_idx <= 0)
+            return -1;
+
+        int idx = (from_idx < Count ? from_idx : Count) - 1;
+        int w = idx / 64;
+        uint64_t word = words_[w] & (~uint64_t(0) >> (63 - idx % 64));
+        while (word == 0)
+        {
+            if (--w < 0)
+                return -1;
+            word = words_[w];
+        }
+
+        return w * 64 + 63 - std::countl_zero(word);
+    }
+
+    constexpr bool operator==(CellMask const&) const = default;
+
+private:
+    static constexpr uint64_t bit(int idx) { return uint64_t(1) << (idx % 64); }
+
+    std::array<uint64_t, word_count> words_ = {};
+};
@@ -0,0 +1,174 @@
+#pragma once
+
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <utility>
+
+// Memory for coroutine frames, reused from one coroutine to the next. A
+// Generator coroutine taking a FrameArena& argument (or a member coroutine of
+// an object called with one) places its frame here instead of on the heap,
+// so creating one per solve does not allocate. Frames are carved off the
+// end of the buffer and must be released in reverse order, which nested or
+// successive generators do naturally; when the arena is full the frame goes
+// to the heap instead.
+class FrameArena
+{
+public:
+    explicit FrameArena(size_t capacity = 16 * 1024)
+        : buffer_(new std::byte[capacity])
+        , capacity_(capacity)
+    {
+    }
+
+    // nullptr when the arena has no room left.
+    void* allocate(size_t size)
+    {
+        size = (size + alignment - 1) & ~(alignment - 1);
+        if (capacity_ - used_ < size)
+            return nullptr;
+
+        void* p = buffer_.get() + used_;
+        used_ += size;
+        return p;
+    }
+
+    void deallocate(void* p, size_t size)
+    {
+        size = (size + alignment - 1) & ~(alignment - 1);
+        if (static_cast<std::byte*>(p) + size == buffer_.get() + used_)
+            used_ -= size;
+    }
+
+    size_t used() const { return used_; }
+
+    static constexpr size_t alignment = __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+
+private:
+    std::unique_ptr<std::byte[]> buffer_;
+    size_t capacity_;
+    size_t used_ = 0;
+};
+
+// Lazy sequence of values produced by a coroutine with co_yield. The values
+// are not copied: iterators refer to the yielded object until the next
+// increment.
+template <typename T>
+class Generator
+{
+public:
+    struct promise_type
+    {
+        const T* value_ = nullptr;
+
+        Generator get_return_object() { return Generator(std::coroutine_handle<promise_type>::from_promise(*this)); }
+
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+
+        std::suspend_always yield_value(T const& value) noexcept
+        {
+            value_ = std::addressof(value);
+            return {};
+        }
+
+        void return_void() noexcept {}
+        void unhandled_exception() { throw; }
+
+        // the frame is preceded by the arena it came from, or nullptr for the heap.
+        template <typename... Args>
+        static void* operator new(size_t size, Args&&... args)
+        {
+            FrameArena* arena = nullptr;
+            ((arena = arena ? arena : arena_of(args)), ...);
+
+            void* p = arena ? arena->allocate(size + header_size) : nullptr;
+            if (p == nullptr)
+            {
+                arena = nullptr;
+                p = ::operator new(size + header_size);
+            }
+
+            *static_cast<FrameArena**>(p) = arena;
+            return static_cast<std::byte*>(p) + header_size;
+        }
+
+        static void operator delete(void* frame, size_t size)
+        {
+            void* p = static_cast<std::byte*>(frame) - header_size;
+            if (FrameArena* arena = *static_cast<FrameArena**>(p))
+                arena->deallocate(p, size + header_size);
+            else
+                ::operator delete(p);
+        }
+
+    private:
+        static constexpr size_t header_size = FrameArena::alignment;
+
+        static FrameArena* arena_of(FrameArena& arena) { return &arena; }
+
+        template <typename A>
+        static FrameArena* arena_of(A const&) { return nullptr; }
+    };
+
+    using handle = std::coroutine_handle<promise_type>;
+
+    class iterator
+    {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using difference_type = std::ptrdiff_t;
+        using value_type = T;
+
+        iterator() = default;
+        explicit iterator(handle coroutine) : coroutine_(coroutine) {}
+
+        T const& operator*() const { return *coroutine_.promise().value_; }
+        T const* operator->() const { return coroutine_.promise().value_; }
+
+        iterator& operator++()
+        {
+            coroutine_.resume();
+            return *this;
+        }
+
+        void operator++(int) { ++*this; }
+
+        bool operator==(std::default_sentinel_t) const { return !coroutine_ || coroutine_.done(); }
+
+    private:
+        handle coroutine_ = nullptr;
+    };
+
+    Generator(Generator&& other) noexcept : coroutine_(std::exchange(other.coroutine_, nullptr)) {}
+
+    Generator& operator=(Generator&& other) noexcept
+    {
+        std::swap(coroutine_, other.coroutine_);
+        return *this;
+    }
+
+    ~Generator()
+    {
+        if (coroutine_)
+            coroutine_.destroy();
+    }
+
+    // runs the coroutine up to its first value.
+    iterator begin()
+    {
+        if (coroutine_)
+            coroutine_.resume();
+        return iterator(coroutine_);
+    }
+
+    std::default_sentinel_t end() const { return {}; }
+
+private:
+    explicit Generator(handle coroutine) : coroutine_(coroutine) {}
+
+    handle coroutine_;
+};
@@ -1,102 +1,181 @@
 #pragma once
 
 #include "ranges.h"
+#include "cell_mask.h"
 
 #include <array>
-#include <optional>
-
-template <typename T>
-struct Ref : public std::reference_wrapper<T>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <type_traits>
+
+// Compile-time description of which cells share a row, column or box, for
+// a grid of BoxH x BoxW boxes (BoxW cells wide, BoxH cells tall).
+// Units are numbered rows first, then columns, then boxes: 0-8, 9-17 and
+// 18-26 for the classic 9x9 grid.
+template <int BoxW, int BoxH>
+struct BasicTopology
 {
-    using base_t = std::reference_wrapper<T>;
-    inline static T dummy_;
+    static constexpr int box_width = BoxW;
+    static constexpr int box_height = BoxH;
+    static constexpr int size = BoxW * BoxH;
+    static constexpr int cell_count = size * size;
+    static constexpr int unit_count = 3 * size;
+    static constexpr int peer_count = 3 * (size - 1) - (BoxW - 1) - (BoxH - 1);
+
+    // narrowest type holding any cell index and the cell count itself.
+    using index_t = std::conditional_t<(cell_count < 256), uint8_t, uint16_t>;
+    using unit_index_t = std::conditional_t<(unit_count < 256), uint8_t, uint16_t>;
+
+    struct CellUnits
+    {
+        unit_index_t row;
+        unit_index_t col;
+        unit_index_t box;
+    };
+
+    static constexpr int row_unit(int row) { return row; }
+    static constexpr int col_unit(int col) { return size + col; }
+    static constexpr int box_unit(int box) { return 2 * size + box; }
+
+    static constexpr std::array<CellUnits, cell_count> units_of = []
+    {
+        std::array<CellUnits, cell_count> table{};
+        for (int idx = 0; idx < cell_count; ++idx)
+        {
+            const int row = idx / size;
+            const int col = idx % size;
+            const int box = (row / BoxH) * BoxH + col / BoxW;
+            table[idx] = {unit_index_t(row), unit_index_t(col), unit_index_t(box)};
+        }
+        return table;
+    }();
+
+    static constexpr std::array<std::array<index_t, size>, unit_count> cells_of = []
+    {
+        std::array<std::array<index_t, size>, unit_count> table{};
+        std::array<int, unit_count> filled{};
+        for (int idx = 0; idx < cell_count; ++idx)
+        {
+            const CellUnits u = units_of[idx];
+            for (int unit : {u.row + 0, size + u.col, 2 * size + u.box})
+                table[unit][filled[unit]++] = index_t(idx);
+        }
+        return table;
+    }();
 
-    Ref() : base_t(dummy_) {}
+    static constexpr std::array<std::array<index_t, peer_count>, cell_count> peers = []
+    {
+        std::array<std::array<index_t, peer_count>, cell_count> table{};
+        for (int idx = 0; idx < cell_count; ++idx)
+        {
+            const CellUnits u = units_of[idx];
+            int n = 0;
 
-    using base_t::operator=;
+            for (int other = 0; other < cell_count; ++other)
+            {
+                const CellUnits o = units_of[other];
+                if (other != idx && (o.row == u.row || o.col == u.col || o.box == u.box))
+                    table[idx][n++] = index_t(other);
+            }
+        }
+        return table;
+    }();
 };
 
-class Grid
+using Topology = BasicTopology<3, 3>;
+
+template <int BoxW, int BoxH>
+class BasicGrid
 {
 public:
-    struct Cell
+    using topology = BasicTopology<BoxW, BoxH>;
+    using index_t = typename topology::index_t;
+
+    static constexpr int size = topology::size;
+
+    // digits past 9 are written as letters: A for 10, B for 11...
+    static constexpr char digit_char(int val)
     {
-        uint8_t idx_ = 0;
-        uint8_t val_ = 0;
-        bool fixed_ = false;
+        return char(val < 10 ? '0' + val : 'A' + (val - 10));
+    }
 
-        void init(uint8_t val)
-        {
-            set(val);
-            fixed_ = (val != 0);
-        }
+    // 0 for blanks ('0' or '.'), -1 for anything that is not a digit of this grid.
+    static constexpr int char_digit(char c)
+    {
+        int val = -1;
+        if (c == '.' || c == '0')
+            val = 0;
+        else if (c >= '1' && c <= '9')
+            val = c - '0';
+        else if (c >= 'A' && c <= 'Z')
+            val = c - 'A' + 10;
+        else if (c >= 'a' && c <= 'z')
+            val = c - 'a' + 10;
+
+        return (val <= size) ? val : -1;
+    }
 
+    struct Cell
+    {
+        index_t idx_ = 0;
+
+        // fills or clears the cell; whether it is a given stays as it is.
         void set(uint8_t val)
         {
             val_ = val;
         }
 
-        char as_char() const { return (val_ != 0) ? val_ + '0' : '_'; }
+        char as_char() const { return (val_ != 0) ? digit_char(val_) : '_'; }
         uint8_t val() const { return val_; }
+        bool given() const { return fixed_; }
 
         operator char() const { return as_char(); }
 
         bool operator==(Cell const& rhs) const { return idx_ == rhs.idx_; }
         auto operator<=>(Cell const& rhs) const { return idx_ <=> rhs.idx_; }
-    };
 
-    std::array<Cell, 81> data_;
-    std::array<std::array<Ref<Cell>, 9>, 9> zones_;
+    private:
+        friend BasicGrid;
 
-    Grid()
-    {
-        constexpr std::array<int, 9> top_left_indexes = {0, 3, 6, 27, 30, 33, 54, 57, 60};
-
-        for (int i = 0; i < 9; ++i)
+        // givens are made by the grid only, which keeps open_ in step.
+        void init(uint8_t val)
         {
-            const int top_left = top_left_indexes[i];
-            auto& zone = zones_[i];
-
-            zone[0] = data_[top_left + 0];
-            zone[1] = data_[top_left + 1];
-            zone[2] = data_[top_left + 2];
-            zone[3] = data_[top_left + 9];
-            zone[4] = data_[top_left + 10];
-            zone[5] = data_[top_left + 11];
-            zone[6] = data_[top_left + 18];
-            zone[7] = data_[top_left + 19];
-            zone[8] = data_[top_left + 20];
+            set(val);
+            fixed_ = (val != 0);
         }
-    }
 
-    void init(std::span<int> values)
+        uint8_t val_ = 0;
+        bool fixed_ = false;
+    };
+
+    void init(std::span<int> values) { init_from(values); }
+    void init(std::span<const uint8_t> values) { init_from(values); }
+
+    // reads one character per cell (see char_digit). Returns false and
+    // leaves the grid untouched unless `text` is exactly one grid of digits.
+    bool parse(std::string_view text)
     {
-        uint8_t idx = 0;
-        auto it = values.begin();
-        for (Cell& c : data_)
+        if (text.size() != topology::cell_count)
+            return false;
+
+        std::array<int, topology::cell_count> values;
+        for (int i = 0; i < topology::cell_count; ++i)
         {
-            int i = *it++;
-            c.init((uint8_t)i);
-            c.idx_ = idx++;
+            if ((values[i] = char_digit(text[i])) < 0)
+                return false;
         }
 
-        constexpr std::array<int, 9> top_left_indexes = {0, 3, 6, 27, 30, 33, 54, 57, 60};
+        init(values);
+        return true;
+    }
 
-        for (int i = 0; i < 9; ++i)
-        {
-            const int top_left = top_left_indexes[i];
-            auto& zone = zones_[i];
-
-            zone[0] = data_[top_left +  0];
-            zone[1] = data_[top_left +  1];
-            zone[2] = data_[top_left +  2];
-            zone[3] = data_[top_left +  9];
-            zone[4] = data_[top_left + 10];
-            zone[5] = data_[top_left + 11];
-            zone[6] = data_[top_left + 18];
-            zone[7] = data_[top_left + 19];
-            zone[8] = data_[top_left + 20];
-        }
+    // turns a cell into a given, or into an open cell for a value of 0.
+    void set_given(int idx, uint8_t val)
+    {
+        data_[idx].idx_ = index_t(idx);
+        data_[idx].init(val);
+        open_.assign(idx, val == 0);
     }
 
     std::span<Cell> cells() { return data_; }
@@ -108,60 +187,102 @@ public:
                                              { return c.as_char(); });
     }
 
-    auto row(int idx)
+    auto unit(int idx)
     {
-        return (views::all(data_) | views::chunk(9))[idx];
+        return views::transform(topology::cells_of[idx], [this](index_t cell_idx) -> Cell&
+                                { return data_[cell_idx]; });
     }
 
-    auto col(int idx)
+    auto unit(int idx) const
     {
-        return views::all(data_) | views::drop(idx) | views::stride(9);
+        return views::transform(topology::cells_of[idx], [this](index_t cell_idx) -> Cell const&
+                                { return data_[cell_idx]; });
     }
 
+    auto row(int idx) { return unit(topology::row_unit(idx)); }
+    auto col(int idx) { return unit(topology::col_unit(idx)); }
+    auto zone(int idx) { return unit(topology::box_unit(idx)); }
 
-    auto zone_of(Cell const& cell) const
-        -> std::optional<decltype(views::all(Grid::zones_[0]))>
+    auto zone_of(Cell const& cell)
     {
-        for (int i = 0; i < zones_.size(); ++i)
-        {
-            auto& zone = zones_[i];
-            for (int j = 0; j < zone.size(); ++j)
-            {
-                Cell const& c = zone[j];
-                if (c == cell)
-                    return std::optional(views::all(zone));
-            }
-        }
+        return zone(topology::units_of[cell.idx_].box);
+    }
 
-        return {};
+    // next cell after `from_idx` that is not a given, -1 when there is none.
+    int next_idx(int from_idx) const
+    {
+        return open_.next(from_idx);
     }
 
-    auto zone(int idx)
+    // last cell before `from_idx` that is not a given, -1 when there is none.
+    int prev_idx(int from_idx) const
     {
-        return views::all(zones_[idx]);
+        return open_.prev(from_idx);
     }
 
-    int next_idx(int from_idx) const
+private:
+    template <typename Values>
+    void init_from(Values const& values)
     {
-        std::span<const Cell> tail(data_.begin() + (from_idx + 1), data_.end());
+        auto it = values.begin();
+        for (int idx = 0; idx < topology::cell_count; ++idx)
+            set_given(idx, (uint8_t)*it++);
+    }
+
+    std::array<Cell, topology::cell_count> data_;
+
+    // cells that are not givens, which the search may fill.
+    CellMask<topology::cell_count> open_;
+};
+
+using Grid = BasicGrid<3, 3>;
+
+// Position independent snapshot of a grid: one byte per cell value and a
+// mask of the givens. It is trivially copyable and fits in two cache lines
+// for 9x9 grids, so saving or handing a grid to another thread is a memcpy.
+template <int BoxW, int BoxH>
+class BasicPackedGrid
+{
+public:
+    using grid_t = BasicGrid<BoxW, BoxH>;
+    using topology = typename grid_t::topology;
 
-        auto next = ranges::find_if(tail, [](Cell const& c) { return !c.fixed_; });
-        
-        if (next == tail.end())
-            return -1;
+    BasicPackedGrid() = default;
+    explicit BasicPackedGrid(grid_t const& grid) { pack(grid); }
 
-        return next->idx_;
+    void pack(grid_t const& grid)
+    {
+        for (auto const& c : grid.cells())
+        {
+            values_[c.idx_] = c.val();
+            givens_.assign(c.idx_, c.given());
+        }
     }
 
-    int prev_idx(int from_idx) const
+    void unpack(grid_t& grid) const
     {
-        std::span<const Cell> head(data_.begin(), data_.begin() + from_idx);
+        for (int idx = 0; idx < topology::cell_count; ++idx)
+        {
+            const bool given = givens_.test(idx);
+            grid.set_given(idx, given ? values_[idx] : 0);
+            if (!given)
+                grid.cells()[idx].set(values_[idx]);
+        }
+    }
 
-        auto prev = ranges::find_if(head | views::reverse, [](Cell const& c) { return !c.fixed_; });
+    uint8_t val(int idx) const { return values_[idx]; }
+    void set(int idx, uint8_t val) { values_[idx] = val; }
+    bool is_given(int idx) const { return givens_.test(idx); }
 
-        if (prev == head.rend())
-            return -1;
+    bool operator==(BasicPackedGrid const&) const = default;
 
-        return prev->idx_;
-    }
+private:
+    std::array<uint8_t, topology::cell_count> values_ = {};
+    CellMask<topology::cell_count> givens_;
 };
+
+using PackedGrid = BasicPackedGrid<3, 3>;
+static_assert(std::is_trivially_copyable_v<PackedGrid> && sizeof(PackedGrid) <= 128);
+
+// Box sizes (width, height) the engines are compiled for.
+#define SUDOKU_BOX_SIZES(X) X(2, 2) X(3, 2) X(2, 3) X(3, 3) X(4, 3) X(3, 4) X(4, 4) X(5, 5)
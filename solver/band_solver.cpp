@@ -0,0 +1,372 @@
+#include "band_solver.h"
+#include "cpu_features.h"
+
+#include <bit>
+
+#if SUDOKU_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+    constexpr uint32_t row_bits = 0x1FF;
+    constexpr uint32_t band_bits = 0x7FFFFFF;
+
+    // the three columns of box `k` of a band.
+    constexpr uint32_t box_bits(int k)
+    {
+        return (07u << 3 * k) * (1u | 1u << 9 | 1u << 18);
+    }
+
+    // vector operations on the three bands, with SSE2 where the target has it.
+    template <typename Bands>
+    Bands vand(Bands const& a, Bands const& b)
+    {
+#if SUDOKU_SSE2
+        Bands r;
+        _mm_store_si128(reinterpret_cast<__m128i*>(r.band.data()),
+                        _mm_and_si128(_mm_load_si128(reinterpret_cast<const __m128i*>(a.band.data())),
+                                      _mm_load_si128(reinterpret_cast<const __m128i*>(b.band.data()))));
+        return r;
+#else
+        return {{a.band[0] & b.band[0], a.band[1] & b.band[1], a.band[2] & b.band[2], 0}};
+#endif
+    }
+
+    template <typename Bands>
+    Bands vor(Bands const& a, Bands const& b)
+    {
+#if SUDOKU_SSE2
+        Bands r;
+        _mm_store_si128(reinterpret_cast<__m128i*>(r.band.data()),
+                        _mm_or_si128(_mm_load_si128(reinterpret_cast<const __m128i*>(a.band.data())),
+                                     _mm_load_si128(reinterpret_cast<const __m128i*>(b.band.data()))));
+        return r;
+#else
+        return {{a.band[0] | b.band[0], a.band[1] | b.band[1], a.band[2] | b.band[2], 0}};
+#endif
+    }
+
+    // a & ~b
+    template <typename Bands>
+    Bands vandnot(Bands const& a, Bands const& b)
+    {
+#if SUDOKU_SSE2
+        Bands r;
+        _mm_store_si128(reinterpret_cast<__m128i*>(r.band.data()),
+                        _mm_andnot_si128(_mm_load_si128(reinterpret_cast<const __m128i*>(b.band.data())),
+                                         _mm_load_si128(reinterpret_cast<const __m128i*>(a.band.data()))));
+        return r;
+#else
+        return {{a.band[0] & ~b.band[0], a.band[1] & ~b.band[1], a.band[2] & ~b.band[2], 0}};
+#endif
+    }
+
+    template <typename Bands>
+    bool none(Bands const& a)
+    {
+#if SUDOKU_SSE2
+        const __m128i v = _mm_load_si128(reinterpret_cast<const __m128i*>(a.band.data()));
+        return _mm_movemask_epi8(_mm_cmpeq_epi32(v, _mm_setzero_si128())) == 0xFFFF;
+#else
+        return (a.band[0] | a.band[1] | a.band[2]) == 0;
+#endif
+    }
+}
+
+const std::array<BandSolver::Bands, Topology::cell_count> BandSolver::cell_masks_ = []
+{
+    std::array<Bands, Topology::cell_count> m = {};
+    for (int idx = 0; idx < Topology::cell_count; ++idx)
+        m[idx].band[idx / 27] = 1u << idx % 27;
+    return m;
+}();
+
+const std::array<BandSolver::Bands, Topology::cell_count> BandSolver::peer_masks_ = []
+{
+    std::array<Bands, Topology::cell_count> m = {};
+    for (int idx = 0; idx < Topology::cell_count; ++idx)
+    {
+        const int b = idx / 27, r = idx % 27 / 9, c = idx % 9;
+        for (int band = 0; band < 3; ++band)
+            m[idx].band[band] = 1u << c | 1u << (c + 9) | 1u << (c + 18);
+        m[idx].band[b] |= row_bits << 9 * r | box_bits(c / 3);
+    }
+    return m;
+}();
+
+BandSolver::BandSolver(Grid& grid) : grid_(&grid)
+{
+    reset(grid);
+}
+
+void BandSolver::reset(Grid& grid)
+{
+    grid_ = &grid;
+    solved_ = false;
+    unsolvable_ = false;
+    depth_ = 0;
+    solve_steps_ = 0;
+    stats_ = {};
+
+    SUDOKU_PHASE(stats_.setup_ns);
+
+    const Bands all = {{band_bits, band_bits, band_bits, 0}};
+    state_.digits.fill(all);
+    state_.unsolved = all;
+    dirty_ = 0x7FFFFFF;
+
+    for (Grid::Cell const& cell : grid.cells())
+    {
+        // a given that is no longer a candidate repeats an earlier one.
+        if (cell.val() != 0 && !place(cell.idx_, cell.val() - 1))
+            unsolvable_ = true;
+    }
+
+    if (!unsolvable_ && !propagate())
+        unsolvable_ = true;
+
+    if (!unsolvable_ && none(state_.unsolved))
+    {
+        solved_ = true;
+        write_solution();
+    }
+}
+
+void BandSolver::solve_step()
+{
+    if (solved_ || unsolvable_)
+        return;
+
+    SUDOKU_PHASE(stats_.search_ns);
+
+    int idx = 0, digit = 0;
+    choose(idx, digit);
+
+    stack_[depth_++] = {state_, uint8_t(idx), uint8_t(digit)};
+    SUDOKU_STAT(stats_.record_decision(depth_ - 1));
+    place(idx, digit);
+    ++solve_steps_;
+
+    // a failed guess leaves the other candidates of its cell to try.
+    while (!propagate())
+    {
+        if (depth_ == 0)
+        {
+            unsolvable_ = true;
+            return;
+        }
+
+        Guess const& guess = stack_[--depth_];
+        state_ = guess.saved;
+        state_.digits[guess.digit] = vandnot(state_.digits[guess.digit], cell_masks_[guess.idx]);
+        dirty_ = 1u << (3 * guess.digit + guess.idx / 27);
+        SUDOKU_STAT(++stats_.backtracks);
+    }
+
+    if (none(state_.unsolved))
+    {
+        solved_ = true;
+        write_solution();
+    }
+}
+
+bool BandSolver::is_solved() const
+{
+    return solved_;
+}
+
+bool BandSolver::is_unsolvable() const
+{
+    return unsolvable_;
+}
+
+bool BandSolver::place(int idx, int digit)
+{
+    Bands const& cell = cell_masks_[idx];
+    Bands const& peers = peer_masks_[idx];
+
+    const int b = idx / 27;
+    if ((state_.digits[digit].band[b] & cell.band[b]) == 0)
+        return false;
+
+    for (int other = 0; other < 9; ++other)
+    {
+        Bands& d = state_.digits[other];
+        dirty_ |= uint32_t((d.band[b] & cell.band[b]) != 0) << (3 * other + b);
+        d = vandnot(d, cell);
+    }
+
+    Bands& d = state_.digits[digit];
+    for (int band = 0; band < 3; ++band)
+        dirty_ |= uint32_t((d.band[band] & peers.band[band]) != 0) << (3 * digit + band);
+
+    d = vor(vandnot(d, peers), cell);
+    state_.unsolved = vandnot(state_.unsolved, cell);
+    return true;
+}
+
+bool BandSolver::propagate()
+{
+    SUDOKU_PHASE(stats_.propagate_ns);
+
+    for (;;)
+    {
+        if (none(state_.unsolved))
+            return true;
+
+        Bands once = {}, twice = {};
+        for (Bands const& d : state_.digits)
+        {
+            twice = vor(twice, vand(once, d));
+            once = vor(once, d);
+        }
+
+        // an unsolved cell without candidates.
+        if (!none(vandnot(state_.unsolved, once)))
+            return false;
+
+        // naked singles: every one found in this pass is placed, unless an
+        // earlier one took its last candidate.
+        const Bands singles = vandnot(state_.unsolved, twice);
+        if (!none(singles))
+        {
+            for (int b = 0; b < 3; ++b)
+            {
+                for (uint32_t m = singles.band[b]; m != 0; m &= m - 1)
+                {
+                    const int idx = 27 * b + std::countr_zero(m);
+
+                    int digit = 0;
+                    while (digit < 9 && (state_.digits[digit].band[b] & (m & (0u - m))) == 0)
+                        ++digit;
+
+                    if (digit == 9)
+                        return false;
+
+                    place(idx, digit);
+                    SUDOKU_STAT(++stats_.propagations);
+                }
+            }
+            continue;
+        }
+
+        const int hidden = place_hidden_singles();
+        if (hidden < 0)
+            return false;
+        if (hidden == 0)
+            return true;
+    }
+}
+
+// Places the hidden singles, digits with one cell left in a row, box or
+// column, for the digits that changed since they were last looked at.
+// Returns how many were placed, or -1 when a unit has no cell left for a
+// digit or a placement took the only cell of another.
+int BandSolver::place_hidden_singles()
+{
+    int placed = 0;
+
+    while (dirty_ != 0)
+    {
+        const int digit = std::countr_zero(dirty_) / 3;
+        const uint32_t bands = dirty_ >> 3 * digit & 7;
+        dirty_ &= ~(7u << 3 * digit);
+
+        Bands const& d = state_.digits[digit];
+
+        // cells alone in their row or box, in the bands that changed, and the
+        // columns holding the digit in a band at all and exactly once.
+        std::array<uint32_t, 3> alone = {}, any, one;
+
+        for (int b = 0; b < 3; ++b)
+        {
+            const uint32_t m = d.band[b];
+            const uint32_t r0 = m & row_bits, r1 = m >> 9 & row_bits, r2 = m >> 18;
+
+            any[b] = r0 | r1 | r2;
+            one[b] = (r0 ^ r1 ^ r2) & ~((r0 & r1) | (r0 & r2) | (r1 & r2));
+
+            if ((bands >> b & 1) == 0)
+                continue;
+
+            for (uint32_t x : {m & row_bits, m & row_bits << 9, m & row_bits << 18, m & box_bits(0), m & box_bits(1), m & box_bits(2)})
+            {
+                if (x == 0)
+                    return -1;
+                if (std::has_single_bit(x))
+                    alone[b] |= x;
+            }
+        }
+
+        if ((any[0] | any[1] | any[2]) != row_bits)
+            return -1;
+
+        const uint32_t column = (one[0] & ~any[1] & ~any[2]) | (one[1] & ~any[0] & ~any[2]) | (one[2] & ~any[0] & ~any[1]);
+        const uint32_t spread = column * (1u | 1u << 9 | 1u << 18);
+
+        for (int b = 0; b < 3; ++b)
+        {
+            // the digit's placed cells are alone in all their units, and an
+            // earlier placement may have just solved or emptied a cell.
+            for (uint32_t x = (alone[b] | (d.band[b] & spread)) & state_.unsolved.band[b]; x != 0; x &= x - 1)
+            {
+                const int idx = 27 * b + std::countr_zero(x);
+                if ((state_.unsolved.band[b] & (x & (0u - x))) == 0)
+                    continue;
+
+                if (!place(idx, digit))
+                    return -1;
+
+                SUDOKU_STAT(++stats_.propagations);
+                ++placed;
+            }
+        }
+    }
+
+    return placed;
+}
+
+// a cell with two candidates if there is one, else one with three, else
+// the first unsolved cell; its smallest candidate is tried first.
+void BandSolver::choose(int& idx, int& digit) const
+{
+    Bands once = {}, twice = {}, thrice = {}, more = {};
+    for (Bands const& d : state_.digits)
+    {
+        more = vor(more, vand(thrice, d));
+        thrice = vor(thrice, vand(twice, d));
+        twice = vor(twice, vand(once, d));
+        once = vor(once, d);
+    }
+
+    Bands pick = vandnot(vand(state_.unsolved, twice), thrice);
+    if (none(pick))
+        pick = vandnot(vand(state_.unsolved, thrice), more);
+    if (none(pick))
+        pick = state_.unsolved;
+
+    int b = 0;
+    while (pick.band[b] == 0)
+        ++b;
+
+    const uint32_t bit = pick.band[b] & (0u - pick.band[b]);
+    idx = 27 * b + std::countr_zero(bit);
+
+    digit = 0;
+    while ((state_.digits[digit].band[b] & bit) == 0)
+        ++digit;
+}
+
+void BandSolver::write_solution()
+{
+    auto cells = grid_->cells();
+    for (int digit = 0; digit < 9; ++digit)
+    {
+        for (int b = 0; b < 3; ++b)
+        {
+            for (uint32_t m = state_.digits[digit].band[b]; m != 0; m &= m - 1)
+                cells[27 * b + std::countr_zero(m)].set(uint8_t(digit + 1));
+        }
+    }
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "grid.h"
+#include "solver_stats.h"
+
+#include <array>
+#include <cstdint>
+
+// Bitboard engine for 9x9 grids. Each digit keeps the cells it may still go
+// in as three 27-bit bands of three rows, one 128-bit vector per digit, so a
+// placement clears a cell and its peers with a few vector operations.
+// Propagation runs naked then hidden singles to a fixed point; guesses go to
+// a cell with two candidates when there is one, and the state before each
+// guess is copied on a stack instead of being undone. The grid only receives
+// the solution once it is found; reset() reuses one instance for many grids.
+class BandSolver
+{
+public:
+    BandSolver(Grid& grid);
+
+    void reset(Grid& grid);
+
+    void solve_step();
+    bool is_solved() const;
+    bool is_unsolvable() const;
+
+    int64_t solve_steps_ = 0;
+    SolverStats stats_;
+
+private:
+    // one bit per cell, bit 9 * row + col of band row / 3; the fourth word
+    // pads the bands to a vector and stays zero.
+    struct alignas(16) Bands
+    {
+        std::array<uint32_t, 4> band;
+    };
+
+    struct State
+    {
+        // cells where each digit is a candidate; a placed cell stays set
+        // for its own digit only.
+        std::array<Bands, 9> digits;
+        Bands unsolved;
+    };
+
+    struct Guess
+    {
+        State saved; // the state before the guess
+        uint8_t idx;
+        uint8_t digit; // 0 to 8
+    };
+
+    bool place(int idx, int digit);
+    bool propagate();
+    int place_hidden_singles();
+    void choose(int& idx, int& digit) const;
+    void write_solution();
+
+    // each cell alone, and with its row, column and box.
+    static const std::array<Bands, Topology::cell_count> cell_masks_;
+    static const std::array<Bands, Topology::cell_count> peer_masks_;
+
+    Grid* grid_;
+    bool solved_ = false;
+    bool unsolvable_ = false;
+
+    State state_;
+
+    // bit 3 * d + b set when digit d lost a candidate in band b since its
+    // last hidden single scan; the others can not have new ones.
+    uint32_t dirty_ = 0;
+
+    // every guess stands for one placed cell, so 81 is always enough.
+    std::array<Guess, Topology::cell_count> stack_;
+    int depth_ = 0;
+};
@@ -0,0 +1,267 @@
+#include "batch.h"
+#include "grid.h"
+#include "solver.h"
+#include "dlx_solver.h"
+#include "band_solver.h"
+#include "lane_solver.h"
+#include "corpus.h"
+#include "line_parser.h"
+#include "solution_writer.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <istream>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    // corpus bytes claimed by a worker at a time, a few hundred puzzles.
+    constexpr size_t slice_bytes = 32 * 1024;
+
+    // engine state reused across the puzzles of one worker.
+    class Worker
+    {
+    public:
+        explicit Worker(BatchOptions const& options) : options_(options)
+        {
+            limits_.max_steps = options.max_steps;
+            limits_.stop = options.stop;
+        }
+
+        SolveStatus solve(Grid& grid)
+        {
+            if (options_.puzzle_timeout.count() > 0)
+                limits_.deadline = SolveLimits::clock::now() + options_.puzzle_timeout;
+
+            switch (options_.engine)
+            {
+            case Engine::backtrack:
+            {
+                Solver solver(grid);
+                return solve_within(solver, limits_).status;
+            }
+            case Engine::bitmask:
+            case Engine::lanes:
+            {
+                BitmaskSolver solver(grid, options_.bitmask);
+                const SolveStatus status = solve_within(solver, limits_).status;
+                table_counters_ += solver.table_counters_;
+                return status;
+            }
+            case Engine::dlx:
+            {
+                if (!dlx_)
+                    dlx_.emplace(grid);
+                else
+                    dlx_->reset(grid);
+                return solve_within(*dlx_, limits_).status;
+            }
+            case Engine::bands:
+            {
+                if (!bands_)
+                    bands_.emplace(grid);
+                else
+                    bands_->reset(grid);
+                return solve_within(*bands_, limits_).status;
+            }
+            }
+
+            return SolveStatus::unsolvable;
+        }
+
+        // solves up to lane_count grids, status[i] for grids[i].
+        void solve(std::span<Grid> grids, std::span<SolveStatus> status)
+        {
+            if (options_.engine != Engine::lanes)
+            {
+                for (size_t i = 0; i < grids.size(); ++i)
+                    status[i] = solve(grids[i]);
+                return;
+            }
+
+            if (limits_.stop.stop_requested())
+            {
+                std::ranges::fill(status, SolveStatus::cancelled);
+                return;
+            }
+
+            std::array<LaneOutcome, lane_count> outcomes;
+            propagate_lanes(grids, outcomes);
+
+            for (size_t i = 0; i < grids.size(); ++i)
+            {
+                switch (outcomes[i])
+                {
+                case LaneOutcome::solved:
+                    status[i] = SolveStatus::solved;
+                    break;
+                case LaneOutcome::unsolvable:
+                    status[i] = SolveStatus::unsolvable;
+                    break;
+                case LaneOutcome::needs_search:
+                    status[i] = solve(grids[i]);
+                    break;
+                }
+            }
+        }
+
+        // this worker's use of the transposition table.
+        TableCounters table_counters_;
+
+    private:
+        BatchOptions const& options_;
+        SolveLimits limits_;
+        std::optional<DlxSolver> dlx_;
+        std::optional<BandSolver> bands_;
+    };
+}
+
+BatchReport solve_batch(std::istream& in, std::ostream& out, BatchOptions const& options)
+{
+    const std::string text(std::istreambuf_iterator<char>(in), {});
+    return solve_batch(std::string_view(text), out, options);
+}
+
+BatchReport solve_batch(std::string_view text, std::ostream& out, BatchOptions const& options)
+{
+    using clock = std::chrono::steady_clock;
+    const auto start = clock::now();
+
+    const CorpusSlices slices(text, slice_bytes);
+    SolutionWriter writer(out, options.format);
+
+    unsigned threads = options.threads ? options.threads : std::thread::hardware_concurrency();
+    threads = std::clamp<unsigned>(threads, 1, (unsigned)std::max<size_t>(1, slices.size()));
+
+    // slices are formatted by the worker that solved them and written in
+    // input order: one finished ahead of its turn waits in `pending`. A
+    // worker claims no slice more than `window` past the next one to write,
+    // so a slow slice holds back at most that many.
+    const size_t window = 2 * threads;
+    std::mutex output_mutex;
+    std::atomic<size_t> next_slice = 0;
+    std::atomic<size_t> next_output = 0;
+    std::map<size_t, std::string> pending;
+
+    auto claim = [&]
+    {
+        const size_t s = next_slice++;
+        for (size_t written = next_output; s < slices.size() && s >= written + window; written = next_output)
+            next_output.wait(written);
+        return s;
+    };
+
+    auto commit = [&](size_t s, std::string& text)
+    {
+        {
+            std::lock_guard lock(output_mutex);
+            if (s != next_output)
+            {
+                pending.emplace(s, std::move(text));
+                text = {};
+                return;
+            }
+
+            writer.write_formatted(text);
+            text.clear();
+            ++next_output;
+
+            for (auto it = pending.begin(); it != pending.end() && it->first == next_output; it = pending.erase(it), ++next_output)
+                writer.write_formatted(it->second);
+        }
+        next_output.notify_all();
+    };
+
+    std::atomic<int64_t> puzzles = 0;
+    std::atomic<int64_t> unsolved = 0;
+    std::atomic<int64_t> stopped = 0;
+    TableCounters table;
+
+    auto work = [&]
+    {
+        Worker worker(options);
+        std::array<Grid, lane_count> grids;
+        std::array<SolveStatus, lane_count> status;
+        const Grid blank;
+        std::array<uint8_t, 81> digits;
+        std::string text;
+        int64_t records = 0, failed = 0, cut_short = 0;
+
+        for (size_t s = claim(); s < slices.size(); s = claim())
+        {
+            std::string_view rest = slices[s];
+
+            // lines are taken a group at a time for the lane engine, the
+            // well-formed ones packed in `grids`; slot[i] is the grid of
+            // line i, -1 for a malformed one.
+            for (;;)
+            {
+                std::array<int, lane_count> slot;
+                int lines = 0, parsed = 0;
+
+                for (std::string_view line; lines < lane_count && !(line = next_record(rest)).empty(); ++lines)
+                {
+                    slot[lines] = -1;
+                    if (parse_puzzle_line(line, digits) == -1)
+                    {
+                        grids[parsed].init(digits);
+                        slot[lines] = parsed++;
+                    }
+                }
+
+                if (lines == 0)
+                    break;
+
+                records += lines;
+
+                worker.solve(std::span(grids).first(parsed), std::span(status).first(parsed));
+
+                for (int i = 0; i < lines; ++i)
+                {
+                    const int g = slot[i];
+                    const bool solved = g != -1 && status[g] == SolveStatus::solved;
+
+                    format_record(solved ? grids[g] : blank, options.format, text);
+                    failed += !solved;
+                    cut_short += g != -1 && !solved && status[g] != SolveStatus::unsolvable;
+                }
+            }
+
+            commit(s, text);
+        }
+
+        puzzles += records;
+        unsolved += failed;
+        stopped += cut_short;
+
+        std::lock_guard lock(output_mutex);
+        table += worker.table_counters_;
+    };
+
+    {
+        std::vector<std::jthread> pool;
+        for (unsigned t = 1; t < threads; ++t)
+            pool.emplace_back(work);
+        work();
+    }
+
+    writer.flush();
+
+    BatchReport report;
+    report.puzzles = puzzles;
+    report.unsolved = unsolved;
+    report.stopped = stopped;
+    report.table = table;
+    report.seconds = std::chrono::duration<double>(clock::now() - start).count();
+    return report;
+}
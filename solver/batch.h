@@ -0,0 +1,59 @@
+#pragma once
+
+#include "bitmask_solver.h"
+#include "solution_writer.h"
+#include "solve_limits.h"
+
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+#include <string_view>
+
+enum class Engine
+{
+    backtrack,
+    bitmask,
+    dlx,
+    lanes, // bitmask propagation on 16 puzzles at once, then bitmask searches
+    bands, // band bitboards, BandSolver
+};
+
+struct BatchOptions
+{
+    Engine engine = Engine::bitmask;
+    BitmaskSolver::Options bitmask = {BitmaskSolver::Selection::mrv, true};
+
+    // worker threads, 0 for one per hardware thread.
+    unsigned threads = 0;
+
+    OutputFormat format = OutputFormat::compact;
+
+    // limits on each puzzle, 0 for none. A puzzle over either is written as
+    // unsolved, so one pathological grid can not hold up a worker.
+    std::chrono::microseconds puzzle_timeout{0};
+    int64_t max_steps = 0;
+
+    // stops the whole batch: puzzles not solved yet are written as unsolved.
+    std::stop_token stop;
+};
+
+struct BatchReport
+{
+    int64_t puzzles = 0;
+    int64_t unsolved = 0; // malformed lines and grids without solution
+    int64_t stopped = 0;  // of those, searches cut short by a limit or the stop token
+    double seconds = 0;
+
+    // use of options.bitmask.table, summed over the workers.
+    TableCounters table;
+};
+
+// Solves every puzzle of `text`, one 81-character line each with `0` or `.`
+// for blanks, and writes the solutions to `out` in input order. Puzzles that
+// can not be solved are written as an empty grid, 81 dots in the compact
+// format. Blank lines and comments from '#' to the end of a line are skipped.
+// `text` is read in place, so it can be a memory mapped file.
+BatchReport solve_batch(std::string_view text, std::ostream& out, BatchOptions const& options);
+
+// same, reading the whole stream first.
+BatchReport solve_batch(std::istream& in, std::ostream& out, BatchOptions const& options);
@@ -0,0 +1,479 @@
+#include "bitmask_solver.h"
+#include "grid.h"
+
+#include <algorithm>
+#include <bit>
+
+namespace
+{
+    template <typename Mask>
+    constexpr Mask bit_of(uint8_t val)
+    {
+        return Mask(1u << (val - 1));
+    }
+
+    template <typename Mask>
+    constexpr uint8_t val_of(Mask bit)
+    {
+        return uint8_t(std::countr_zero(bit) + 1);
+    }
+
+    // one key per (cell, value), value v of cell idx at idx * size + v - 1.
+    template <typename Grid>
+    const auto zobrist_keys = []
+    {
+        std::array<uint64_t, Grid::topology::cell_count * Grid::size> keys;
+
+        // SplitMix64, so the keys are the same in every build.
+        uint64_t state = Grid::size;
+        for (uint64_t& key : keys)
+        {
+            uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+            key = z ^ (z >> 31);
+        }
+        return keys;
+    }();
+
+    template <typename Grid>
+    uint64_t zobrist_key(int idx, uint8_t val)
+    {
+        return zobrist_keys<Grid>[idx * Grid::size + val - 1];
+    }
+
+    template <typename Topology>
+    constexpr std::array<int, 3> units_of(int idx)
+    {
+        const typename Topology::CellUnits u = Topology::units_of[idx];
+        return {Topology::row_unit(u.row), Topology::col_unit(u.col), Topology::box_unit(u.box)};
+    }
+}
+
+template <int BoxW, int BoxH>
+BasicBitmaskSolver<BoxW, BoxH>::BasicBitmaskSolver(grid_t& grid) : BasicBitmaskSolver(grid, Options{})
+{
+}
+
+template <int BoxW, int BoxH>
+BasicBitmaskSolver<BoxW, BoxH>::BasicBitmaskSolver(grid_t& grid, Options options)
+    : grid_(grid)
+    , options_(options)
+{
+    SUDOKU_PHASE(stats_.setup_ns);
+
+    for (auto const& cell : grid_.cells())
+    {
+        if (cell.val() == 0)
+            continue;
+
+        const mask_t bit = bit_of<mask_t>(cell.val());
+        for (int unit : units_of<topology>(cell.idx_))
+        {
+            // a given repeated in one of its units can never be solved.
+            if (units_[unit] & bit)
+                unsolvable_ = true;
+
+            units_[unit] |= bit;
+        }
+
+        hash_ ^= zobrist_key<grid_t>(cell.idx_, cell.val());
+    }
+
+    // the candidates of every cell, for the counts and the first sweep of
+    // propagation.
+    std::array<mask_t, topology::cell_count> picture;
+    for (int idx = 0; idx < topology::cell_count; ++idx)
+    {
+        picture[idx] = candidates(idx);
+        counts_[idx] = uint8_t(std::popcount(picture[idx]));
+    }
+
+    if (!unsolvable_ && options_.propagate)
+        unsolvable_ = !propagate(&picture);
+
+    next_idx_ = unsolvable_ ? -1 : select_next(-1);
+}
+
+template <int BoxW, int BoxH>
+void BasicBitmaskSolver<BoxW, BoxH>::solve_step()
+{
+    if (next_idx_ == -1)
+        return;
+
+    SUDOKU_PHASE(stats_.search_ns);
+
+    NoEvents none;
+    for (Move move = advance(none); move == Move::rejected || move == Move::backtracked;)
+        move = advance(none);
+}
+
+template <int BoxW, int BoxH>
+int64_t BasicBitmaskSolver<BoxW, BoxH>::count_solutions(int64_t limit, SolveLimits const& limits)
+{
+    int64_t count = 0;
+    int64_t steps = 0;
+
+    while (count < limit)
+    {
+        for (; next_idx_ != -1; ++steps)
+        {
+            if (limits.spent(steps) || (steps % limit_check_steps == 0 && limits.interrupted()))
+                return count;
+
+            solve_step();
+        }
+
+        if (unsolvable_)
+        {
+            undo(0);
+            break;
+        }
+
+        if (++count < limit)
+            skip_solution();
+    }
+
+    return count;
+}
+
+template <int BoxW, int BoxH>
+void BasicBitmaskSolver<BoxW, BoxH>::skip_solution()
+{
+    if (!is_solved())
+        return;
+
+    // from a solution, a move takes the last decision back.
+    NoEvents none;
+    advance(none);
+}
+
+template <int BoxW, int BoxH>
+Generator<typename BasicBitmaskSolver<BoxW, BoxH>::Event> BasicBitmaskSolver<BoxW, BoxH>::events(FrameArena&, unsigned kinds)
+{
+    // the events of one move: a decision, what propagation forced after it
+    // and, when it fails, everything placed taken back.
+    struct Buffer
+    {
+        unsigned kinds;
+        int size = 0;
+        std::array<Event, 2 * topology::cell_count + 1> events = {};
+
+        void operator()(Event const& e) { events[size++] = e; }
+    };
+
+    Buffer buffer{kinds};
+
+    while (!unsolvable_)
+    {
+        if (next_idx_ == -1 && (kinds & Event::solution))
+            co_yield Event{Event::solution, -1, 0};
+
+        buffer.size = 0;
+        {
+            SUDOKU_PHASE(stats_.search_ns);
+            advance(buffer);
+        }
+
+        for (int i = 0; i < buffer.size; ++i)
+            co_yield buffer.events[i];
+    }
+
+    // drops what propagation placed in the constructor, as count_solutions does.
+    undo(0);
+}
+
+template <int BoxW, int BoxH>
+template <typename Sink>
+typename BasicBitmaskSolver<BoxW, BoxH>::Move BasicBitmaskSolver<BoxW, BoxH>::advance(Sink& sink)
+{
+    if (const int idx = next_idx_; idx != -1)
+    {
+        // candidates strictly above the last value tried.
+        if (const mask_t cands = candidates(idx) & mask_t(all_digits << from_); cands != 0)
+        {
+            const uint8_t val = val_of(cands);
+            const Decision decision = {index_t(idx), index_t(trail_size_)};
+            place(idx, val);
+            SUDOKU_STAT(stats_.record_decision(depth_));
+
+            if (sink.kinds & Event::decision)
+                sink(Event{Event::decision, idx, val});
+
+            const bool consistent = !options_.propagate || propagate();
+
+            if (sink.kinds & Event::forced)
+            {
+                for (int t = decision.mark + 1; t < trail_size_; ++t)
+                    sink(Event{Event::forced, trail_[t], grid_.cells()[trail_[t]].val()});
+            }
+
+            if (consistent && !known_dead_end())
+            {
+                decisions_[depth_++] = decision;
+                next_idx_ = select_next(idx);
+                from_ = 0;
+                ++solve_steps_;
+
+                if (next_idx_ == -1)
+                    live_depth_ = depth_;
+                return Move::placed;
+            }
+
+            undo(decision.mark, sink);
+            SUDOKU_STAT(++stats_.backtracks);
+            from_ = val;
+            return Move::rejected;
+        }
+
+        // every value of `idx` failed, so the values placed so far can not
+        // be completed, unless a solution was found below them.
+        if (options_.table && depth_ > live_depth_)
+        {
+            options_.table->store_dead_end(hash_);
+            ++table_counters_.stores;
+        }
+    }
+
+    if (depth_ == 0)
+    {
+        unsolvable_ = true;
+        next_idx_ = -1;
+        return Move::exhausted;
+    }
+
+    const Decision prev = decisions_[--depth_];
+    live_depth_ = std::min(live_depth_, depth_);
+    next_idx_ = prev.idx;
+    from_ = grid_.cells()[prev.idx].val();
+    undo(prev.mark, sink);
+    SUDOKU_STAT(++stats_.backtracks);
+    return Move::backtracked;
+}
+
+template <int BoxW, int BoxH>
+bool BasicBitmaskSolver<BoxW, BoxH>::is_solved() const
+{
+    return next_idx_ == -1 && !unsolvable_;
+}
+
+template <int BoxW, int BoxH>
+bool BasicBitmaskSolver<BoxW, BoxH>::is_unsolvable() const
+{
+    return unsolvable_;
+}
+
+template <int BoxW, int BoxH>
+int BasicBitmaskSolver<BoxW, BoxH>::branch_cell() const
+{
+    return next_idx_;
+}
+
+template <int BoxW, int BoxH>
+typename BasicBitmaskSolver<BoxW, BoxH>::mask_t BasicBitmaskSolver<BoxW, BoxH>::candidates(int idx) const
+{
+    const typename topology::CellUnits u = topology::units_of[idx];
+    const mask_t used = units_[topology::row_unit(u.row)]
+                        | units_[topology::col_unit(u.col)]
+                        | units_[topology::box_unit(u.box)];
+    return ~used & all_digits;
+}
+
+template <int BoxW, int BoxH>
+bool BasicBitmaskSolver<BoxW, BoxH>::known_dead_end()
+{
+    if (!options_.table)
+        return false;
+
+    const bool hit = options_.table->probe(hash_);
+    ++(hit ? table_counters_.hits : table_counters_.misses);
+    return hit;
+}
+
+template <int BoxW, int BoxH>
+uint64_t BasicBitmaskSolver<BoxW, BoxH>::state_hash() const
+{
+    return hash_;
+}
+
+template <int BoxW, int BoxH>
+void BasicBitmaskSolver<BoxW, BoxH>::set(int idx, uint8_t val)
+{
+    const mask_t bit = bit_of<mask_t>(val);
+
+    if (options_.selection == Selection::mrv)
+    {
+        for (index_t peer : topology::peers[idx])
+            counts_[peer] -= (candidates(peer) & bit) != 0;
+    }
+
+    for (int unit : units_of<topology>(idx))
+        units_[unit] |= bit;
+
+    hash_ ^= zobrist_key<grid_t>(idx, val);
+    grid_.cells()[idx].set(val);
+}
+
+template <int BoxW, int BoxH>
+void BasicBitmaskSolver<BoxW, BoxH>::unset(int idx)
+{
+    auto& cell = grid_.cells()[idx];
+
+    const mask_t bit = bit_of<mask_t>(cell.val());
+    for (int unit : units_of<topology>(idx))
+        units_[unit] &= mask_t(~bit);
+
+    if (options_.selection == Selection::mrv)
+    {
+        for (index_t peer : topology::peers[idx])
+            counts_[peer] += (candidates(peer) & bit) != 0;
+    }
+
+    hash_ ^= zobrist_key<grid_t>(idx, cell.val());
+    cell.set(0);
+}
+
+template <int BoxW, int BoxH>
+void BasicBitmaskSolver<BoxW, BoxH>::place(int idx, uint8_t val)
+{
+    set(idx, val);
+    trail_[trail_size_++] = index_t(idx);
+}
+
+template <int BoxW, int BoxH>
+template <typename Sink>
+void BasicBitmaskSolver<BoxW, BoxH>::undo(int mark, Sink& sink)
+{
+    while (trail_size_ > mark)
+    {
+        const int idx = trail_[--trail_size_];
+        if (sink.kinds & Event::removed)
+            sink(Event{Event::removed, idx, grid_.cells()[idx].val()});
+
+        unset(idx);
+    }
+}
+
+template <int BoxW, int BoxH>
+void BasicBitmaskSolver<BoxW, BoxH>::undo(int mark)
+{
+    NoEvents none;
+    undo(mark, none);
+}
+
+template <int BoxW, int BoxH>
+bool BasicBitmaskSolver<BoxW, BoxH>::propagate(std::array<mask_t, topology::cell_count> const* picture)
+{
+    SUDOKU_PHASE(stats_.propagate_ns);
+
+    auto cells = grid_.cells();
+
+    // `picture` holds the candidates until the first placement; after it,
+    // and in the propagation following a decision, which only changes a few
+    // cells, they are looked up one cell at a time.
+    bool fresh = picture != nullptr;
+
+    auto cands_of = [&](int idx) -> mask_t
+    {
+        return fresh ? (*picture)[idx] : candidates(idx);
+    };
+
+    bool changed = true;
+    auto assign = [&](int idx, uint8_t val)
+    {
+        place(idx, val);
+        SUDOKU_STAT(++stats_.propagations);
+        fresh = false;
+        changed = true;
+    };
+
+    while (changed)
+    {
+        changed = false;
+
+        // naked singles: empty cells with a single candidate left.
+        for (int idx = 0; idx < topology::cell_count; ++idx)
+        {
+            if (cells[idx].val() != 0)
+                continue;
+
+            const mask_t cands = cands_of(idx);
+            if (cands == 0)
+                return false;
+
+            if (std::has_single_bit(cands))
+                assign(idx, val_of(cands));
+        }
+
+        // hidden singles: digits with a single possible cell in a unit.
+        for (int unit = 0; unit < topology::unit_count; ++unit)
+        {
+            auto const& unit_cells = topology::cells_of[unit];
+
+            mask_t once = 0, twice = 0;
+            for (index_t idx : unit_cells)
+            {
+                if (cells[idx].val() != 0)
+                    continue;
+
+                const mask_t cands = cands_of(idx);
+                twice |= once & cands;
+                once |= cands;
+            }
+
+            if ((once | units_[unit]) != all_digits)
+                return false;
+
+            for (mask_t hidden = once & ~twice; hidden != 0; hidden &= hidden - 1)
+            {
+                const mask_t bit = hidden & mask_t(-hidden);
+                for (index_t idx : unit_cells)
+                {
+                    if (cells[idx].val() != 0 || !(cands_of(idx) & bit))
+                        continue;
+
+                    assign(idx, val_of(bit));
+                    break;
+                }
+            }
+        }
+    }
+
+    return true;
+}
+
+template <int BoxW, int BoxH>
+int BasicBitmaskSolver<BoxW, BoxH>::select_next(int from_idx) const
+{
+    auto cells = grid_.cells();
+
+    if (options_.selection == Selection::mrv)
+    {
+        int best = -1;
+        for (int idx = 0; idx < (int)cells.size(); ++idx)
+        {
+            if (cells[idx].val() != 0 || (best != -1 && counts_[idx] >= counts_[best]))
+                continue;
+
+            best = idx;
+            if (counts_[idx] <= 1)
+                break;
+        }
+
+        return best;
+    }
+
+    // every cell before the last decision is filled, so the first empty one
+    // after it is the next in index order.
+    for (int idx = from_idx + 1; idx < (int)cells.size(); ++idx)
+    {
+        if (cells[idx].val() == 0)
+            return idx;
+    }
+
+    return -1;
+}
+
+#define SUDOKU_INSTANTIATE(W, H) template class BasicBitmaskSolver<W, H>;
+SUDOKU_BOX_SIZES(SUDOKU_INSTANTIATE)
+#undef SUDOKU_INSTANTIATE
@@ -0,0 +1,187 @@
+#pragma once
+
+#include "grid.h"
+#include "coro_generator.h"
+#include "solver_stats.h"
+#include "solve_limits.h"
+#include "transposition_table.h"
+
+#include <array>
+#include <cstdint>
+#include <type_traits>
+
+// Options shared by every grid size.
+struct BitmaskSolverBase
+{
+    enum class Selection
+    {
+        in_order, // next empty cell in index order
+        mrv,      // empty cell with the fewest candidates
+    };
+
+    struct Options
+    {
+        Selection selection = Selection::in_order;
+
+        // place naked and hidden singles on the initial grid and after
+        // every decision.
+        bool propagate = false;
+
+        // dead ends found by earlier searches, skipped when a decision of
+        // solve_step() or count_solutions() leads back to one, and where
+        // those record their own. Not owned; nullptr searches without one.
+        TranspositionTable* table = nullptr;
+    };
+
+    // a step of the search, as yielded by events().
+    struct Event
+    {
+        enum Kind : uint8_t
+        {
+            decision = 1, // a guessed value placed in cell `idx`
+            forced = 2,   // a value placed by propagation after a decision
+            removed = 4,  // a value taken back when backtracking
+            solution = 8, // the grid holds a solution, `idx` is -1
+        };
+
+        Kind kind;
+        int idx;
+        uint8_t val;
+    };
+
+    static constexpr unsigned all_events = Event::decision | Event::forced | Event::removed | Event::solution;
+};
+
+// Backtracking engine keeping one occupancy mask per row, column and box.
+// Bit (v - 1) of a mask is set when digit v is placed in that unit, so the
+// candidates of a cell are the complement of three ORed masks.
+template <int BoxW, int BoxH>
+class BasicBitmaskSolver : public BitmaskSolverBase
+{
+public:
+    using grid_t = BasicGrid<BoxW, BoxH>;
+    using mask_t = std::conditional_t<(grid_t::size <= 16), uint16_t, uint32_t>;
+
+    BasicBitmaskSolver(grid_t& grid);
+    BasicBitmaskSolver(grid_t& grid, Options options);
+
+    void solve_step();
+    bool is_solved() const;
+    bool is_unsolvable() const;
+
+    // Counts solutions, continuing the search past each one until `limit`
+    // are found or the search is exhausted. Solutions are not copied: when
+    // the limit is reached the grid holds the last one found, otherwise the
+    // search ends unsolvable with the grid back to its starting state.
+    // A limit of 2 tells unique grids apart for about the cost of a solve.
+    // When `limits` run out first the search stops where it is, neither
+    // solved nor unsolvable, and the solutions found so far are returned.
+    int64_t count_solutions(int64_t limit, SolveLimits const& limits = {});
+
+    // moves on from the solution in the grid, so that the next solve_step()
+    // looks for another one; nothing happens unless is_solved().
+    void skip_solution();
+
+    // Runs the search inside a coroutine, yielding the events whose kinds
+    // are set in `kinds` as they happen, so a caller can step through it,
+    // stop at the first solution or enumerate them all. The frame lives in
+    // `arena`, so starting one allocates nothing. At a solution event the grid
+    // holds the solution and is_solved() is true; iterating to the end
+    // exhausts the search like count_solutions and restores the grid. The
+    // moves are those solve_step() makes, from where the search stands.
+    Generator<Event> events(FrameArena& arena, unsigned kinds = all_events);
+
+    // cell the next step branches on, -1 once solved or unsolvable.
+    int branch_cell() const;
+
+    // digits still allowed in a cell, bit (v - 1) for digit v.
+    mask_t candidates(int idx) const;
+
+    // Zobrist hash of the values in the grid, givens included: the XOR of a
+    // fixed random key for each (cell, value) placed.
+    uint64_t state_hash() const;
+
+    int64_t solve_steps_ = 0;
+    SolverStats stats_;
+
+    // lookups in and stores to options.table by this solver.
+    TableCounters table_counters_;
+
+private:
+    using topology = typename grid_t::topology;
+    using index_t = typename topology::index_t;
+
+    static constexpr mask_t all_digits = mask_t((1u << grid_t::size) - 1);
+
+    struct Decision
+    {
+        index_t idx;
+        index_t mark; // trail size before the decision was placed
+    };
+
+    // what one call of advance() did.
+    enum class Move : uint8_t
+    {
+        placed,      // a decision held, the search went one level deeper
+        rejected,    // a decision failed and was taken back
+        backtracked, // the cell had no candidate left, its decision was taken back
+        exhausted,   // no candidate left above the first decision
+    };
+
+    // receives the events of a move; this one drops them.
+    struct NoEvents
+    {
+        static constexpr unsigned kinds = 0;
+        void operator()(Event const&) {}
+    };
+
+    void set(int idx, uint8_t val);
+    void unset(int idx);
+
+    // The one move of the search that solve_step(), count_solutions() and
+    // events() are all made of: tries the next candidate of next_idx_ above
+    // from_, or takes back the last decision when there is none or the grid
+    // is solved. Placements and removals are reported to `sink`.
+    template <typename Sink>
+    Move advance(Sink& sink);
+
+    void place(int idx, uint8_t val);
+    template <typename Sink>
+    void undo(int mark, Sink& sink);
+    void undo(int mark);
+    // `picture`, when given, holds the current candidates of every cell.
+    bool propagate(std::array<mask_t, topology::cell_count> const* picture = nullptr);
+
+    // true when the placed values are a dead end of options.table.
+    bool known_dead_end();
+
+    int select_next(int from_idx) const;
+
+    grid_t& grid_;
+    Options options_;
+    int next_idx_ = 0;
+    uint8_t from_ = 0; // the values of next_idx_ up to this one were tried
+    bool unsolvable_ = false;
+
+    // occupancy mask of every unit, indexed like topology units.
+    std::array<mask_t, topology::unit_count> units_ = {};
+
+    // candidates(idx) popcount for every cell, kept up to date by set/unset
+    // when the selection policy needs it.
+    std::array<uint8_t, topology::cell_count> counts_ = {};
+
+    // cells filled by the search, decided or forced, in placement order.
+    std::array<index_t, topology::cell_count> trail_ = {};
+    int trail_size_ = 0;
+
+    std::array<Decision, topology::cell_count> decisions_ = {};
+    int depth_ = 0;
+
+    uint64_t hash_ = 0;
+
+    // most decisions on the path to a solution found by count_solutions;
+    // the states up to that depth lead to it and are not dead ends.
+    int live_depth_ = -1;
+};
+
+using BitmaskSolver = BasicBitmaskSolver<3, 3>;
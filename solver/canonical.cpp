@@ -0,0 +1,362 @@
+#include "canonical.h"
+
+#include <algorithm>
+#include <bit>
+#include <vector>
+
+namespace
+{
+    // The columns of the result still open: output position p holds source
+    // column order[p], and the ones a cut does not separate may still be
+    // swapped with each other. Cuts always split the stacks; whole stacks
+    // may still swap with a neighbour they are tied to.
+    struct Columns
+    {
+        std::array<uint8_t, 9> order = {0, 1, 2, 3, 4, 5, 6, 7, 8};
+        uint16_t cuts = 1u << 2 | 1u << 5; // bit p between positions p and p + 1
+        uint8_t ties = 0b11;               // bit s between stacks s and s + 1
+    };
+
+    // a transformation with its first rows chosen.
+    struct Node
+    {
+        Columns columns;
+        std::array<uint8_t, 9> rows = {};
+        uint8_t bands = 0; // source bands used
+        bool transpose = false;
+    };
+
+    // the puzzle both ways round: values[t][row][col] and a bit per filled
+    // column in filled[t][row].
+    struct Source
+    {
+        std::array<std::array<std::array<uint8_t, 9>, 9>, 2> values;
+        std::array<std::array<uint16_t, 9>, 2> filled = {};
+    };
+
+    // Arranges a row with `filled` columns as early in the order as the
+    // open choices allow, blanks first, narrowing the choices down to the
+    // ones giving that arrangement. Returns the row's pattern, the first
+    // column in the high bit.
+    unsigned refine(Columns& c, uint16_t filled)
+    {
+        // blanks to the front of each cell of swappable columns.
+        for (int start = 0, p = 0; p < 9; ++p)
+        {
+            if (p != 8 && (c.cuts >> p & 1) == 0)
+                continue;
+
+            std::array<uint8_t, 3> blanks, clues;
+            int nb = 0, nc = 0;
+            for (int q = start; q <= p; ++q)
+            {
+                if (filled >> c.order[q] & 1)
+                    clues[nc++] = c.order[q];
+                else
+                    blanks[nb++] = c.order[q];
+            }
+
+            std::copy_n(blanks.begin(), nb, c.order.begin() + start);
+            std::copy_n(clues.begin(), nc, c.order.begin() + start + nb);
+            if (nb != 0 && nc != 0)
+                c.cuts |= uint16_t(1u << (start + nb - 1));
+
+            start = p + 1;
+        }
+
+        auto pattern_of = [&](int s)
+        {
+            unsigned v = 0;
+            for (int q = 3 * s; q < 3 * s + 3; ++q)
+                v = v << 1 | (filled >> c.order[q] & 1);
+            return v;
+        };
+
+        std::array<unsigned, 3> pattern = {pattern_of(0), pattern_of(1), pattern_of(2)};
+
+        // tied stacks in order of their patterns, moving their columns and
+        // inner cuts along.
+        for (int s = 1; s < 3; ++s)
+        {
+            for (int t = s; t > 0 && (c.ties >> (t - 1) & 1) && pattern[t] < pattern[t - 1]; --t)
+            {
+                std::swap_ranges(c.order.begin() + 3 * t - 3, c.order.begin() + 3 * t, c.order.begin() + 3 * t);
+                std::swap(pattern[t], pattern[t - 1]);
+
+                const uint16_t lo = c.cuts >> (3 * t - 3) & 3, hi = c.cuts >> (3 * t) & 3;
+                c.cuts = uint16_t((c.cuts & ~(3u << (3 * t - 3) | 3u << (3 * t))) | hi << (3 * t - 3) | lo << (3 * t));
+            }
+        }
+
+        for (int s = 0; s < 2; ++s)
+        {
+            if (pattern[s] != pattern[s + 1])
+                c.ties &= uint8_t(~(1u << s));
+        }
+
+        return pattern[0] << 6 | pattern[1] << 3 | pattern[2];
+    }
+
+    // Looks through the column orders a finished node leaves open, keeping
+    // in `best` the smallest cells with digits renumbered by first appearance.
+    // Columns without a clue are left where they are, swapping them changes
+    // nothing.
+    class DigitSearch
+    {
+    public:
+        explicit DigitSearch(Source const& source) : source_(source) {}
+
+        void run(Node const& node)
+        {
+            node_ = &node;
+            const uint16_t used = used_columns(node.transpose);
+
+            // every order of the stacks that keeps untied ones in place.
+            std::array<uint8_t, 3> stacks = {0, 1, 2};
+            do
+            {
+                bool allowed = true;
+                for (int s = 0; s < 3 && allowed; ++s)
+                {
+                    const int lo = std::min<int>(s, stacks[s]), hi = std::max<int>(s, stacks[s]);
+                    for (int t = lo; t < hi; ++t)
+                        allowed = allowed && (node.columns.ties >> t & 1);
+
+                    // stacks without a clue give the same cells anywhere.
+                    if (stacks[s] != s && !stack_used(node.columns, stacks[s], used))
+                        allowed = false;
+                }
+
+                if (!allowed)
+                    continue;
+
+                Columns c = node.columns;
+                for (int s = 0; s < 3; ++s)
+                {
+                    std::copy_n(node.columns.order.begin() + 3 * stacks[s], 3, c.order.begin() + 3 * s);
+                    c.cuts = uint16_t((c.cuts & ~(3u << 3 * s)) | (node.columns.cuts >> (3 * stacks[s]) & 3) << 3 * s);
+                }
+
+                permute_cells(c, 0, used);
+            } while (std::next_permutation(stacks.begin(), stacks.end()));
+        }
+
+        bool found_ = false;
+        std::array<uint8_t, 81> best_ = {};
+        Symmetry symmetry_;
+
+    private:
+        uint16_t used_columns(bool transpose) const
+        {
+            uint16_t used = 0;
+            for (uint16_t row : source_.filled[transpose])
+                used |= row;
+            return used;
+        }
+
+        static bool stack_used(Columns const& c, int s, uint16_t used)
+        {
+            return ((used >> c.order[3 * s] | used >> c.order[3 * s + 1] | used >> c.order[3 * s + 2]) & 1) != 0;
+        }
+
+        // every order within the cells from position `from` on.
+        void permute_cells(Columns& c, int from, uint16_t used)
+        {
+            if (from == 9)
+            {
+                compare(c);
+                return;
+            }
+
+            int end = from;
+            while (end < 8 && (c.cuts >> end & 1) == 0)
+                ++end;
+
+            // the columns of a cell have the same clues, so one tells for all.
+            if (end == from || (used >> c.order[from] & 1) == 0)
+            {
+                permute_cells(c, end + 1, used);
+                return;
+            }
+
+            // a cell lies within a stack, so it has at most three columns.
+            for (int p = from + 1; p <= end; ++p)
+            {
+                for (int q = p; q > from && c.order[q] < c.order[q - 1]; --q)
+                    std::swap(c.order[q], c.order[q - 1]);
+            }
+
+            do
+                permute_cells(c, end + 1, used);
+            while (std::next_permutation(c.order.begin() + from, c.order.begin() + end + 1));
+        }
+
+        void compare(Columns const& c)
+        {
+            auto const& values = source_.values[node_->transpose];
+
+            std::array<uint8_t, 10> label = {};
+            uint8_t next = 1;
+            std::array<uint8_t, 81> cells;
+            bool smaller = !found_;
+
+            for (int r = 0; r < 9; ++r)
+            {
+                for (int col = 0; col < 9; ++col)
+                {
+                    uint8_t v = values[node_->rows[r]][c.order[col]];
+                    if (v != 0)
+                    {
+                        if (label[v] == 0)
+                            label[v] = next++;
+                        v = label[v];
+                    }
+
+                    const int i = 9 * r + col;
+                    if (!smaller)
+                    {
+                        if (v > best_[i])
+                            return;
+                        smaller = v < best_[i];
+                    }
+                    cells[i] = v;
+                }
+            }
+
+            if (!smaller)
+                return;
+
+            found_ = true;
+            best_ = cells;
+
+            symmetry_.transpose = node_->transpose;
+            symmetry_.rows = node_->rows;
+            symmetry_.cols = c.order;
+
+            // digits missing from the puzzle take the labels left, in order.
+            for (uint8_t v = 1; v <= 9; ++v)
+            {
+                if (label[v] == 0)
+                    label[v] = next++;
+            }
+            symmetry_.digits = label;
+        }
+
+        Source const& source_;
+        Node const* node_ = nullptr;
+    };
+}
+
+Grid Symmetry::apply(Grid const& grid) const
+{
+    auto cells = grid.cells();
+
+    std::array<uint8_t, 81> values;
+    for (int r = 0; r < 9; ++r)
+    {
+        for (int c = 0; c < 9; ++c)
+        {
+            const int from = transpose ? 9 * cols[c] + rows[r] : 9 * rows[r] + cols[c];
+            values[9 * r + c] = digits[cells[from].val()];
+        }
+    }
+
+    Grid result;
+    result.init(values);
+    return result;
+}
+
+Symmetry Symmetry::inverse() const
+{
+    Symmetry inv;
+    inv.transpose = transpose;
+
+    for (uint8_t i = 0; i < 9; ++i)
+    {
+        // transposing swaps which of the two orders applies to rows.
+        (transpose ? inv.cols : inv.rows)[rows[i]] = i;
+        (transpose ? inv.rows : inv.cols)[cols[i]] = i;
+    }
+
+    for (uint8_t v = 0; v <= 9; ++v)
+        inv.digits[digits[v]] = v;
+
+    return inv;
+}
+
+CanonicalForm canonical_form(Grid const& puzzle)
+{
+    auto cells = puzzle.cells();
+
+    Source source;
+    for (int r = 0; r < 9; ++r)
+    {
+        for (int c = 0; c < 9; ++c)
+        {
+            const uint8_t v = cells[9 * r + c].val();
+            source.values[0][r][c] = v;
+            source.values[1][c][r] = v;
+            source.filled[0][r] |= uint16_t((v != 0) << c);
+            source.filled[1][c] |= uint16_t((v != 0) << r);
+        }
+    }
+
+    // every node of a level gives the smallest pattern so far.
+    std::vector<Node> level = {Node{}, Node{}}, next;
+    level[1].transpose = true;
+
+    for (int k = 0; k < 9; ++k)
+    {
+        unsigned best = ~0u;
+        next.clear();
+
+        auto consider = [&](Node const& node, int row)
+        {
+            Node child = node;
+            const unsigned pattern = refine(child.columns, source.filled[node.transpose][row]);
+            if (pattern > best)
+                return;
+
+            if (pattern < best)
+            {
+                best = pattern;
+                next.clear();
+            }
+
+            child.rows[k] = uint8_t(row);
+            child.bands |= uint8_t(1u << row / 3);
+            next.push_back(child);
+        };
+
+        for (Node const& node : level)
+        {
+            if (k % 3 == 0)
+            {
+                for (int row = 0; row < 9; ++row)
+                {
+                    if ((node.bands >> row / 3 & 1) == 0)
+                        consider(node, row);
+                }
+                continue;
+            }
+
+            const int band = node.rows[k - 1] / 3;
+            for (int row = 3 * band; row < 3 * band + 3; ++row)
+            {
+                if (std::find(node.rows.begin() + (k - k % 3), node.rows.begin() + k, row) == node.rows.begin() + k)
+                    consider(node, row);
+            }
+        }
+
+        std::swap(level, next);
+    }
+
+    DigitSearch digits(source);
+    for (Node const& node : level)
+        digits.run(node);
+
+    CanonicalForm result;
+    result.symmetry = digits.symmetry_;
+    result.grid.init(digits.best_);
+    return result;
+}
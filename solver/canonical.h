@@ -0,0 +1,48 @@
+#pragma once
+
+#include "grid.h"
+
+#include <array>
+#include <cstdint>
+
+// One of the transformations that map every valid 9x9 grid to another one:
+// an optional transposition, then a reordering of the rows and columns that
+// keeps bands and stacks together, then a relabelling of the digits.
+struct Symmetry
+{
+    bool transpose = false;
+
+    // row r of the result is row rows[r] of the (transposed) grid, and the
+    // same for columns.
+    std::array<uint8_t, 9> rows = {0, 1, 2, 3, 4, 5, 6, 7, 8};
+    std::array<uint8_t, 9> cols = {0, 1, 2, 3, 4, 5, 6, 7, 8};
+
+    // digit v becomes digits[v]; blanks stay blank.
+    std::array<uint8_t, 10> digits = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+
+    // the transformed grid, every filled cell a given.
+    Grid apply(Grid const& grid) const;
+
+    Symmetry inverse() const;
+
+    bool operator==(Symmetry const&) const = default;
+};
+
+struct CanonicalForm
+{
+    Grid grid;
+    Symmetry symmetry; // takes the puzzle to `grid`
+};
+
+// The representative of a puzzle among all its transformed copies, the same
+// for every copy, so it can key a deduplication set or a cache of solutions:
+// a solution of the canonical grid maps back with symmetry.inverse(). The
+// representative has the smallest pattern of filled cells read row by row,
+// blanks first, then among the transformations giving that pattern the
+// smallest cells once digits are renumbered in order of first appearance.
+// Rows are chosen one at a time, keeping only the choices that tie for the
+// smallest pattern so far while the column order is narrowed down with them,
+// so an ordinary puzzle takes a few microseconds. Grids with almost every
+// cell filled give the pattern nothing to tell orders apart by and take up
+// to tens of milliseconds.
+CanonicalForm canonical_form(Grid const& puzzle);
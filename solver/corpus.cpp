@@ -0,0 +1,160 @@
+#include "corpus.h"
+
+#include <algorithm>
+
+#ifdef _WIN32
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+#ifdef _WIN32
+
+bool MappedFile::open(std::string const& path)
+{
+    close();
+
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size))
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    file_ = file;
+    if (size.QuadPart == 0)
+        return true; // empty files can not be mapped
+
+    mapping_ = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping_ != nullptr)
+        data_ = static_cast<const char*>(MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+
+    if (data_ == nullptr)
+    {
+        close();
+        return false;
+    }
+
+    size_ = (size_t)size.QuadPart;
+    return true;
+}
+
+void MappedFile::close()
+{
+    if (data_ != nullptr)
+        UnmapViewOfFile(data_);
+    if (mapping_ != nullptr)
+        CloseHandle(mapping_);
+    if (file_ != nullptr)
+        CloseHandle(file_);
+
+    data_ = nullptr;
+    size_ = 0;
+    mapping_ = nullptr;
+    file_ = nullptr;
+}
+
+#else
+
+bool MappedFile::open(std::string const& path)
+{
+    close();
+
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0)
+    {
+        ::close(fd);
+        return false;
+    }
+
+    if (st.st_size > 0)
+    {
+        void* data = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED)
+        {
+            ::close(fd);
+            return false;
+        }
+
+        madvise(data, (size_t)st.st_size, MADV_SEQUENTIAL);
+        data_ = static_cast<const char*>(data);
+        size_ = (size_t)st.st_size;
+    }
+
+    // the mapping keeps the file alive.
+    ::close(fd);
+    return true;
+}
+
+void MappedFile::close()
+{
+    if (data_ != nullptr)
+        munmap(const_cast<char*>(data_), size_);
+
+    data_ = nullptr;
+    size_ = 0;
+}
+
+#endif
+
+std::string_view next_record(std::string_view& text)
+{
+    while (!text.empty())
+    {
+        const size_t end = std::min(text.find('\n'), text.size());
+        std::string_view line = text.substr(0, end);
+        text.remove_prefix(std::min(end + 1, text.size()));
+
+        line = line.substr(0, line.find('#'));
+        while (!line.empty() && (line.back() == '\r' || line.back() == ' ' || line.back() == '\t'))
+            line.remove_suffix(1);
+
+        if (!line.empty())
+            return line;
+    }
+
+    return {};
+}
+
+CorpusSlices::CorpusSlices(std::string_view text, size_t slice_bytes)
+    : text_(text)
+    , slice_bytes_(std::max<size_t>(slice_bytes, 1))
+    , count_((text.size() + slice_bytes_ - 1) / slice_bytes_)
+{
+}
+
+std::string_view CorpusSlices::operator[](size_t i) const
+{
+    const size_t begin = bound(i);
+    return text_.substr(begin, bound(i + 1) - begin);
+}
+
+size_t CorpusSlices::bound(size_t i) const
+{
+    if (i == 0)
+        return 0;
+    if (i >= count_)
+        return text_.size();
+
+    // past the end of the line holding the last byte of slice i - 1.
+    return std::min(text_.find('\n', i * slice_bytes_ - 1), text_.size() - 1) + 1;
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// Read-only memory map of a whole file. The pages are loaded by the OS as
+// they are read, so corpora larger than the heap can be walked in place.
+class MappedFile
+{
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(MappedFile const&) = delete;
+    MappedFile& operator=(MappedFile const&) = delete;
+
+    // false when the file can not be opened or mapped.
+    bool open(std::string const& path);
+    void close();
+
+    std::string_view text() const { return {data_, size_}; }
+
+private:
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+
+#ifdef _WIN32
+    void* file_ = nullptr;
+    void* mapping_ = nullptr;
+#endif
+};
+
+// Puzzle corpora hold one puzzle per line. Anything from a '#' to the end of
+// the line is a comment, and lines left blank are not records.
+
+// pops lines off the front of `text` up to the next record and returns it,
+// without its comment or trailing whitespace. Empty once `text` is exhausted.
+std::string_view next_record(std::string_view& text);
+
+// `text` cut at line ends into runs of whole lines of about `slice_bytes`.
+// Slice i ends with the line holding byte (i + 1) * slice_bytes - 1 and
+// starts after slice i - 1, so finding it only reads up to the next line end
+// after each bound: threads can take slices of a large corpus without a pass
+// over it first. A line longer than `slice_bytes` leaves some slices empty.
+class CorpusSlices
+{
+public:
+    CorpusSlices(std::string_view text, size_t slice_bytes);
+
+    size_t size() const { return count_; }
+
+    std::string_view operator[](size_t i) const;
+
+private:
+    // where slice i starts.
+    size_t bound(size_t i) const;
+
+    std::string_view text_;
+    size_t slice_bytes_;
+    size_t count_;
+};
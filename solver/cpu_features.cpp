@@ -0,0 +1,39 @@
+#include "cpu_features.h"
+
+#if SUDOKU_X86 && defined(_MSC_VER)
+#include <immintrin.h>
+#include <intrin.h>
+#endif
+
+namespace
+{
+    bool detect_avx2()
+    {
+#if SUDOKU_X86 && defined(_MSC_VER)
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7)
+            return false;
+
+        // OSXSAVE and AVX, then the OS saving the ymm registers.
+        __cpuid(info, 1);
+        if ((info[2] & (1 << 27)) == 0 || (info[2] & (1 << 28)) == 0)
+            return false;
+        if ((_xgetbv(0) & 0x6) != 0x6)
+            return false;
+
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+#elif SUDOKU_X86
+        return __builtin_cpu_supports("avx2");
+#else
+        return false;
+#endif
+    }
+}
+
+bool cpu_has_avx2()
+{
+    static const bool avx2 = detect_avx2();
+    return avx2;
+}
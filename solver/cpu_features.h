@@ -0,0 +1,26 @@
+#pragma once
+
+// Vector kernels are compiled for their instruction set function by function
+// and picked at run time, so the binary still runs on CPUs without them.
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define SUDOKU_X86 1
+#else
+#define SUDOKU_X86 0
+#endif
+
+// SSE2 is part of every x86-64 target, so it needs no check at run time.
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SUDOKU_SSE2 1
+#else
+#define SUDOKU_SSE2 0
+#endif
+
+#if SUDOKU_X86 && (defined(__GNUC__) || defined(__clang__))
+#define SUDOKU_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define SUDOKU_TARGET_AVX2
+#endif
+
+// true when the CPU and OS both support AVX2.
+bool cpu_has_avx2();
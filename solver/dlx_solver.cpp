@@ -0,0 +1,237 @@
+#include "dlx_solver.h"
+#include "grid.h"
+
+namespace
+{
+    // node 0 is the root header, columns are nodes 1 to 324 and the 729
+    // candidate rows (cell * 9 + digit - 1) follow with 4 nodes each.
+    constexpr int root = 0;
+    constexpr int column_count = 4 * Topology::cell_count;
+    constexpr int first_row_node = column_count + 1;
+    constexpr int row_count = Topology::cell_count * 9;
+    constexpr int node_count = first_row_node + 4 * row_count;
+
+    constexpr int row_node(int idx, uint8_t val)
+    {
+        return first_row_node + 4 * (idx * 9 + val - 1);
+    }
+
+    constexpr int row_of(int node)
+    {
+        return (node - first_row_node) / 4;
+    }
+
+    constexpr std::array<int, 4> columns_of(int row)
+    {
+        const int idx = row / 9;
+        const int digit = row % 9;
+        const Topology::CellUnits u = Topology::units_of[idx];
+
+        return {
+            1 + idx,
+            1 + 81 + u.row * 9 + digit,
+            1 + 162 + u.col * 9 + digit,
+            1 + 243 + u.box * 9 + digit,
+        };
+    }
+}
+
+DlxSolver::DlxSolver(Grid& grid) : grid_(&grid)
+{
+    nodes_.resize(node_count);
+    reset(grid);
+}
+
+void DlxSolver::reset(Grid& grid)
+{
+    grid_ = &grid;
+    solved_ = false;
+    unsolvable_ = false;
+    depth_ = 0;
+    solve_steps_ = 0;
+    stats_ = {};
+
+    SUDOKU_PHASE(stats_.setup_ns);
+    build();
+
+    std::array<bool, column_count + 1> covered = {};
+    for (Grid::Cell const& cell : grid.cells())
+    {
+        if (cell.val() == 0)
+            continue;
+
+        // a given whose constraints are already met clashes with another.
+        const int first = row_node(cell.idx_, cell.val());
+        for (int col : columns_of(row_of(first)))
+        {
+            if (covered[col])
+                unsolvable_ = true;
+            covered[col] = true;
+        }
+
+        if (unsolvable_)
+            return;
+
+        cover(nodes_[first].col);
+        for (int j = nodes_[first].right; j != first; j = nodes_[j].right)
+            cover(nodes_[j].col);
+    }
+
+    solved_ = (nodes_[root].right == root);
+}
+
+void DlxSolver::solve_step()
+{
+    if (solved_ || unsolvable_)
+        return;
+
+    SUDOKU_PHASE(stats_.search_ns);
+
+    int col = choose_column();
+    cover(col);
+    int row = nodes_[col].down;
+
+    // walk back up the stack until a column still has an untried row.
+    while (row == col)
+    {
+        uncover(col);
+
+        if (depth_ == 0)
+        {
+            unsolvable_ = true;
+            return;
+        }
+
+        row = stack_[--depth_];
+        col = nodes_[row].col;
+        deselect(row);
+        SUDOKU_STAT(++stats_.backtracks);
+        row = nodes_[row].down;
+    }
+
+    SUDOKU_STAT(stats_.record_decision(depth_));
+    stack_[depth_++] = uint16_t(row);
+    select(row);
+
+    ++solve_steps_;
+    solved_ = (nodes_[root].right == root);
+}
+
+bool DlxSolver::is_solved() const
+{
+    return solved_;
+}
+
+bool DlxSolver::is_unsolvable() const
+{
+    return unsolvable_;
+}
+
+void DlxSolver::build()
+{
+    for (int col = 0; col <= column_count; ++col)
+    {
+        nodes_[col] = {
+            uint16_t(col == 0 ? column_count : col - 1),
+            uint16_t(col == column_count ? 0 : col + 1),
+            uint16_t(col),
+            uint16_t(col),
+            uint16_t(col),
+        };
+        sizes_[col] = 0;
+    }
+
+    for (int row = 0; row < row_count; ++row)
+    {
+        const int first = first_row_node + 4 * row;
+        const std::array<int, 4> cols = columns_of(row);
+
+        for (int k = 0; k < 4; ++k)
+        {
+            const int node = first + k;
+            const int col = cols[k];
+
+            // append at the bottom of the column.
+            nodes_[node] = {
+                uint16_t(first + (k + 3) % 4),
+                uint16_t(first + (k + 1) % 4),
+                nodes_[col].up,
+                uint16_t(col),
+                uint16_t(col),
+            };
+            nodes_[nodes_[col].up].down = uint16_t(node);
+            nodes_[col].up = uint16_t(node);
+            ++sizes_[col];
+        }
+    }
+}
+
+void DlxSolver::cover(int col)
+{
+    Node& c = nodes_[col];
+    nodes_[c.right].left = c.left;
+    nodes_[c.left].right = c.right;
+
+    for (int i = c.down; i != col; i = nodes_[i].down)
+    {
+        for (int j = nodes_[i].right; j != i; j = nodes_[j].right)
+        {
+            Node& n = nodes_[j];
+            nodes_[n.down].up = n.up;
+            nodes_[n.up].down = n.down;
+            --sizes_[n.col];
+        }
+    }
+}
+
+void DlxSolver::uncover(int col)
+{
+    Node& c = nodes_[col];
+
+    for (int i = c.up; i != col; i = nodes_[i].up)
+    {
+        for (int j = nodes_[i].left; j != i; j = nodes_[j].left)
+        {
+            Node& n = nodes_[j];
+            ++sizes_[n.col];
+            nodes_[n.down].up = uint16_t(j);
+            nodes_[n.up].down = uint16_t(j);
+        }
+    }
+
+    nodes_[c.right].left = uint16_t(col);
+    nodes_[c.left].right = uint16_t(col);
+}
+
+void DlxSolver::select(int row_node)
+{
+    for (int j = nodes_[row_node].right; j != row_node; j = nodes_[j].right)
+        cover(nodes_[j].col);
+
+    const int row = row_of(row_node);
+    grid_->cells()[row / 9].set(uint8_t(row % 9 + 1));
+}
+
+void DlxSolver::deselect(int row_node)
+{
+    for (int j = nodes_[row_node].left; j != row_node; j = nodes_[j].left)
+        uncover(nodes_[j].col);
+
+    grid_->cells()[row_of(row_node) / 9].set(0);
+}
+
+int DlxSolver::choose_column() const
+{
+    int best = nodes_[root].right;
+    for (int col = best; col != root; col = nodes_[col].right)
+    {
+        if (sizes_[col] < sizes_[best])
+        {
+            best = col;
+            if (sizes_[best] <= 1)
+                break;
+        }
+    }
+
+    return best;
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "grid.h"
+#include "solver_stats.h"
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+// Algorithm X over the 324 exact cover constraints of a grid (one value per
+// cell, each digit once per row, column and box), with Dancing Links.
+// The node pool is allocated once; reset() rebuilds the links in place so
+// one instance can solve many grids without allocating.
+class DlxSolver
+{
+public:
+    DlxSolver(Grid& grid);
+
+    void reset(Grid& grid);
+
+    void solve_step();
+    bool is_solved() const;
+    bool is_unsolvable() const;
+
+    int64_t solve_steps_ = 0;
+    SolverStats stats_;
+
+private:
+    struct Node
+    {
+        uint16_t left;
+        uint16_t right;
+        uint16_t up;
+        uint16_t down;
+        uint16_t col;
+    };
+
+    void build();
+    void cover(int col);
+    void uncover(int col);
+
+    void select(int row_node);
+    void deselect(int row_node);
+    int choose_column() const;
+
+    Grid* grid_;
+    bool solved_ = false;
+    bool unsolvable_ = false;
+
+    std::vector<Node> nodes_;
+    std::array<uint16_t, 325> sizes_ = {};
+
+    // first node of the row selected at each search depth.
+    std::array<uint16_t, 81> stack_ = {};
+    int depth_ = 0;
+};
@@ -0,0 +1,116 @@
+#include "generator.h"
+#include "bitmask_solver.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <numeric>
+#include <thread>
+
+namespace
+{
+    // SplitMix64, chosen over the standard engines and distributions so the
+    // puzzles for a seed are the same with every standard library.
+    struct Random
+    {
+        uint64_t state;
+
+        uint64_t next()
+        {
+            uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+            return z ^ (z >> 31);
+        }
+
+        template <typename T, size_t N>
+        void shuffle(std::array<T, N>& values)
+        {
+            for (size_t i = N - 1; i > 0; --i)
+                std::swap(values[i], values[next() % (i + 1)]);
+        }
+    };
+
+    constexpr BitmaskSolver::Options search_options = {BitmaskSolver::Selection::mrv, true};
+
+    // boxes on the diagonal share no unit, so any digit order in each of them
+    // is part of some complete grid; the solver fills in the rest.
+    Grid random_solution(Random& random)
+    {
+        std::array<int, 81> values{};
+        std::array<int, 9> digits;
+        std::iota(digits.begin(), digits.end(), 1);
+
+        for (int box : {0, 4, 8})
+        {
+            random.shuffle(digits);
+
+            auto const& cells = Topology::cells_of[Topology::box_unit(box)];
+            for (int k = 0; k < 9; ++k)
+                values[cells[k]] = digits[k];
+        }
+
+        Grid grid;
+        grid.init(values);
+
+        BitmaskSolver solver(grid, search_options);
+        solver.count_solutions(1);
+        return grid;
+    }
+
+    bool is_unique(Grid const& puzzle)
+    {
+        Grid grid = puzzle;
+        BitmaskSolver solver(grid, search_options);
+        return solver.count_solutions(2) == 1;
+    }
+}
+
+Grid generate_puzzle(uint64_t seed)
+{
+    Random random{seed};
+    Grid puzzle = random_solution(random);
+
+    std::array<uint8_t, 81> order;
+    std::iota(order.begin(), order.end(), uint8_t(0));
+    random.shuffle(order);
+
+    for (uint8_t idx : order)
+    {
+        const uint8_t val = puzzle.cells()[idx].val();
+
+        puzzle.set_given(idx, 0);
+        if (!is_unique(puzzle))
+            puzzle.set_given(idx, val);
+    }
+
+    return puzzle;
+}
+
+std::vector<Grid> generate_puzzles(int64_t count, GeneratorOptions const& options)
+{
+    std::vector<Grid> puzzles((size_t)std::max<int64_t>(count, 0));
+    std::atomic<int64_t> next = 0;
+
+    auto work = [&]
+    {
+        for (int64_t i = next++; i < count; i = next++)
+        {
+            // distinct, well mixed seed per puzzle.
+            Random mix{options.seed ^ (uint64_t(i) * 0xD1B54A32D192ED03ull)};
+            puzzles[i] = generate_puzzle(mix.next());
+        }
+    };
+
+    unsigned threads = options.threads ? options.threads : std::thread::hardware_concurrency();
+    threads = std::clamp<unsigned>(threads, 1, (unsigned)std::max<int64_t>(count, 1));
+
+    {
+        std::vector<std::jthread> pool;
+        for (unsigned t = 1; t < threads; ++t)
+            pool.emplace_back(work);
+        work();
+    }
+
+    return puzzles;
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include "grid.h"
+
+#include <cstdint>
+#include <vector>
+
+struct GeneratorOptions
+{
+    uint64_t seed = 0;
+
+    // worker threads, 0 for one per hardware thread.
+    unsigned threads = 0;
+};
+
+// Builds a random complete grid, then removes clues in random order as long
+// as the solution stays unique, so the puzzle is minimal: no remaining clue
+// can be removed. The same seed always gives the same puzzle.
+Grid generate_puzzle(uint64_t seed);
+
+// Generates `count` puzzles over a pool of threads. Puzzle i only depends on
+// the seed and i, so the result does not depend on the number of threads.
+std::vector<Grid> generate_puzzles(int64_t count, GeneratorOptions const& options);
@@ -0,0 +1,227 @@
+#include "lane_solver.h"
+#include "cpu_features.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+
+namespace
+{
+    using topology = Topology;
+
+    constexpr uint16_t all_digits = 0x1FF;
+
+#if defined(__GNUC__) || defined(__clang__)
+#define SUDOKU_ALWAYS_INLINE [[gnu::always_inline]] inline
+
+    // the vector helpers are always inlined, so the ABI of returning a
+    // lanes_t never applies. Arguments go by reference: GCC reports those
+    // with a note the pragma does not silence.
+#if !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wpsabi"
+#endif
+
+    // one 16-bit candidate mask per lane; the compiler lowers the operators
+    // to the vector width of the function they are inlined in.
+    using lanes_t = uint16_t __attribute__((vector_size(2 * lane_count)));
+
+    SUDOKU_ALWAYS_INLINE lanes_t splat(uint16_t v)
+    {
+        return lanes_t{} + v;
+    }
+
+    // all ones in the lanes where `a` is zero.
+    SUDOKU_ALWAYS_INLINE lanes_t zero_lanes(lanes_t const& a)
+    {
+        return (lanes_t)(a == 0);
+    }
+#else
+#define SUDOKU_ALWAYS_INLINE __forceinline
+
+    struct lanes_t
+    {
+        std::array<uint16_t, lane_count> v = {};
+
+        uint16_t& operator[](int l) { return v[l]; }
+        uint16_t operator[](int l) const { return v[l]; }
+    };
+
+    template <typename Op>
+    lanes_t lanewise(lanes_t a, lanes_t b, Op op)
+    {
+        for (int l = 0; l < lane_count; ++l)
+            a[l] = uint16_t(op(a[l], b[l]));
+        return a;
+    }
+
+    lanes_t operator&(lanes_t a, lanes_t b) { return lanewise(a, b, [](uint16_t x, uint16_t y) { return x & y; }); }
+    lanes_t operator|(lanes_t a, lanes_t b) { return lanewise(a, b, [](uint16_t x, uint16_t y) { return x | y; }); }
+    lanes_t operator^(lanes_t a, lanes_t b) { return lanewise(a, b, [](uint16_t x, uint16_t y) { return x ^ y; }); }
+    lanes_t operator-(lanes_t a, lanes_t b) { return lanewise(a, b, [](uint16_t x, uint16_t y) { return x - y; }); }
+    lanes_t operator~(lanes_t a) { return lanewise(a, a, [](uint16_t x, uint16_t) { return ~x; }); }
+    lanes_t& operator|=(lanes_t& a, lanes_t b) { return a = a | b; }
+    lanes_t& operator&=(lanes_t& a, lanes_t b) { return a = a & b; }
+
+    lanes_t splat(uint16_t v)
+    {
+        lanes_t a;
+        a.v.fill(v);
+        return a;
+    }
+
+    lanes_t zero_lanes(lanes_t a)
+    {
+        for (int l = 0; l < lane_count; ++l)
+            a[l] = a[l] == 0 ? 0xFFFF : 0;
+        return a;
+    }
+#endif
+
+    SUDOKU_ALWAYS_INLINE bool any(lanes_t const& a)
+    {
+        uint16_t r = 0;
+        for (int l = 0; l < lane_count; ++l)
+            r |= a[l];
+        return r != 0;
+    }
+
+    // all ones in the lanes of `a` holding exactly one digit.
+    SUDOKU_ALWAYS_INLINE lanes_t single_lanes(lanes_t const& a)
+    {
+        return zero_lanes(a & (a - splat(1))) & ~zero_lanes(a);
+    }
+
+    struct LaneState
+    {
+        std::array<lanes_t, topology::cell_count> cands;
+        lanes_t failed; // all ones in the lanes that hit a contradiction
+    };
+
+    // One sweep per loop over the units, each removing the digits of its
+    // single cells from the others and reducing a cell to the digits only it
+    // can hold. A unit sees the reductions of the units before it, so easy
+    // grids settle in a few sweeps. A cell left with two digits only it can
+    // hold is not a contradiction caught here; its lane stalls and the scalar
+    // search finds it.
+    SUDOKU_ALWAYS_INLINE void propagate_state(LaneState& s)
+    {
+        const lanes_t full = splat(all_digits);
+
+        for (bool changed = true; changed;)
+        {
+            lanes_t diff = {};
+
+            for (auto const& unit_cells : topology::cells_of)
+            {
+                lanes_t placed = {}, repeated = {};
+                for (auto idx : unit_cells)
+                {
+                    const lanes_t single = s.cands[idx] & single_lanes(s.cands[idx]);
+                    repeated |= placed & single;
+                    placed |= single;
+                }
+
+                lanes_t once = {}, twice = {};
+                std::array<lanes_t, Grid::size> reduced;
+                for (int i = 0; i < Grid::size; ++i)
+                {
+                    const lanes_t c = s.cands[unit_cells[i]];
+                    const lanes_t keep = single_lanes(c);
+                    const lanes_t r = (c & keep) | (c & ~placed & ~keep);
+
+                    twice |= once & r;
+                    once |= r;
+                    reduced[i] = r;
+                }
+
+                const lanes_t hidden = once & ~twice;
+                lanes_t empty = {};
+                for (int i = 0; i < Grid::size; ++i)
+                {
+                    const lanes_t r = reduced[i];
+                    const lanes_t h = r & hidden;
+                    const lanes_t has_hidden = ~zero_lanes(h);
+                    const lanes_t next = (h & has_hidden) | (r & ~has_hidden);
+
+                    empty |= zero_lanes(next);
+                    diff |= next ^ s.cands[unit_cells[i]];
+                    s.cands[unit_cells[i]] = next;
+                }
+
+                s.failed |= empty | ~zero_lanes(repeated) | ~zero_lanes(once ^ full);
+            }
+
+            // failed lanes may keep changing, they are not waited for.
+            changed = any(diff & ~s.failed);
+        }
+    }
+
+    void propagate_generic(LaneState& s)
+    {
+        propagate_state(s);
+    }
+
+#if SUDOKU_X86 && (defined(__GNUC__) || defined(__clang__))
+    SUDOKU_TARGET_AVX2 void propagate_avx2(LaneState& s)
+    {
+        propagate_state(s);
+    }
+#endif
+
+    using propagate_fn = void (*)(LaneState&);
+
+    propagate_fn select_kernel()
+    {
+#if SUDOKU_X86 && (defined(__GNUC__) || defined(__clang__))
+        if (cpu_has_avx2())
+            return propagate_avx2;
+#endif
+        return propagate_generic;
+    }
+}
+
+void propagate_lanes(std::span<Grid> grids, std::span<LaneOutcome> outcomes)
+{
+    static const propagate_fn propagate = select_kernel();
+
+    const int lanes = (int)std::min<size_t>(grids.size(), lane_count);
+
+    // unused lanes start as empty grids, which settle at once.
+    LaneState s;
+    s.cands.fill(splat(all_digits));
+    s.failed = lanes_t{};
+
+    for (int l = 0; l < lanes; ++l)
+    {
+        auto cells = grids[l].cells();
+        for (int idx = 0; idx < topology::cell_count; ++idx)
+        {
+            if (const uint8_t val = cells[idx].val(); val != 0)
+                s.cands[idx][l] = uint16_t(1u << (val - 1));
+        }
+    }
+
+    propagate(s);
+
+    for (int l = 0; l < lanes; ++l)
+    {
+        if (s.failed[l] != 0)
+        {
+            outcomes[l] = LaneOutcome::unsolvable;
+            continue;
+        }
+
+        auto cells = grids[l].cells();
+        bool full = true;
+        for (int idx = 0; idx < topology::cell_count; ++idx)
+        {
+            const uint16_t c = s.cands[idx][l];
+            if (std::has_single_bit(c))
+                cells[idx].set(uint8_t(std::countr_zero(c) + 1));
+            else
+                full = false;
+        }
+
+        outcomes[l] = full ? LaneOutcome::solved : LaneOutcome::needs_search;
+    }
+}
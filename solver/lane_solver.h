@@ -0,0 +1,21 @@
+#pragma once
+
+#include "grid.h"
+
+#include <cstdint>
+#include <span>
+
+enum class LaneOutcome : uint8_t
+{
+    solved,
+    unsolvable,
+    needs_search, // propagation stalled before the grid was full
+};
+
+// Runs naked and hidden singles on up to lane_count 9x9 grids in lockstep,
+// each grid in one 16-bit lane of the candidate vectors, with AVX2 when the
+// CPU has it. Every grid is left with the values its lane deduced, which is
+// the fixed point BitmaskSolver's propagation reaches on it.
+void propagate_lanes(std::span<Grid> grids, std::span<LaneOutcome> outcomes);
+
+inline constexpr int lane_count = 16;
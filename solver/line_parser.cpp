@@ -0,0 +1,125 @@
+#include "line_parser.h"
+#include "cpu_features.h"
+
+#include <algorithm>
+#include <bit>
+
+#if SUDOKU_X86
+#include <immintrin.h>
+#endif
+
+namespace
+{
+    constexpr int cell_count = 81;
+
+    // the length error of a line that is not 81 characters, -1 otherwise.
+    int length_error(std::string_view line)
+    {
+        if (line.size() == cell_count)
+            return -1;
+
+        return line.size() < cell_count ? (int)line.size() : cell_count;
+    }
+
+#if SUDOKU_SSE2
+    // converts the 16 characters at `pos`, returning the bits of the lanes
+    // that are neither a digit nor a dot.
+    int parse_block_sse2(const char* line, uint8_t* digits, int pos)
+    {
+        const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(line + pos));
+
+        // '0'..'9' become 0..9 and everything else wraps above 9 once unsigned.
+        const __m128i d = _mm_sub_epi8(c, _mm_set1_epi8('0'));
+        const __m128i digit = _mm_cmpeq_epi8(_mm_min_epu8(d, _mm_set1_epi8(9)), d);
+        const __m128i dot = _mm_cmpeq_epi8(c, _mm_set1_epi8('.'));
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(digits + pos), _mm_andnot_si128(dot, d));
+        return ~_mm_movemask_epi8(_mm_or_si128(digit, dot)) & 0xFFFF;
+    }
+#endif
+
+#if SUDOKU_X86
+    SUDOKU_TARGET_AVX2 uint32_t parse_block_avx2(const char* line, uint8_t* digits, int pos)
+    {
+        const __m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(line + pos));
+
+        const __m256i d = _mm256_sub_epi8(c, _mm256_set1_epi8('0'));
+        const __m256i digit = _mm256_cmpeq_epi8(_mm256_min_epu8(d, _mm256_set1_epi8(9)), d);
+        const __m256i dot = _mm256_cmpeq_epi8(c, _mm256_set1_epi8('.'));
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(digits + pos), _mm256_andnot_si256(dot, d));
+        return ~uint32_t(_mm256_movemask_epi8(_mm256_or_si256(digit, dot)));
+    }
+#endif
+
+    using parse_fn = int (*)(std::string_view, std::span<uint8_t, 81>);
+
+    parse_fn select_parser()
+    {
+        if (cpu_has_avx2())
+            return parse_puzzle_line_avx2;
+
+        return SUDOKU_SSE2 ? parse_puzzle_line_sse2 : parse_puzzle_line_scalar;
+    }
+}
+
+int parse_puzzle_line(std::string_view line, std::span<uint8_t, 81> digits)
+{
+    static const parse_fn parse = select_parser();
+
+    // a bad character ahead of the wrong length is reported first.
+    if (line.size() != cell_count)
+        return parse_puzzle_line_scalar(line, digits);
+
+    return parse(line, digits);
+}
+
+int parse_puzzle_line_scalar(std::string_view line, std::span<uint8_t, 81> digits)
+{
+    const int n = (int)std::min<size_t>(line.size(), cell_count);
+    for (int i = 0; i < n; ++i)
+    {
+        const char c = line[i];
+        if (c == '.')
+            digits[i] = 0;
+        else if (c >= '0' && c <= '9')
+            digits[i] = uint8_t(c - '0');
+        else
+            return i;
+    }
+
+    return length_error(line);
+}
+
+// the blocks overlap at the end so no lane is read past the line; results on
+// overlapping lanes are the same, and earlier blocks are checked first so the
+// first error found is the first of the line.
+int parse_puzzle_line_sse2(std::string_view line, std::span<uint8_t, 81> digits)
+{
+#if SUDOKU_SSE2
+    for (int pos : {0, 16, 32, 48, 64, cell_count - 16})
+    {
+        if (const int bad = parse_block_sse2(line.data(), digits.data(), pos); bad != 0)
+            return pos + std::countr_zero((unsigned)bad);
+    }
+
+    return -1;
+#else
+    return parse_puzzle_line_scalar(line, digits);
+#endif
+}
+
+SUDOKU_TARGET_AVX2 int parse_puzzle_line_avx2(std::string_view line, std::span<uint8_t, 81> digits)
+{
+#if SUDOKU_X86
+    for (int pos : {0, 32, cell_count - 32})
+    {
+        if (const uint32_t bad = parse_block_avx2(line.data(), digits.data(), pos); bad != 0)
+            return pos + std::countr_zero(bad);
+    }
+
+    return -1;
+#else
+    return parse_puzzle_line_scalar(line, digits);
+#endif
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+// Converts an 81-character puzzle line, `1-9` for givens and `0` or `.` for
+// blanks, to one digit byte per cell. Returns -1 on success, or the position
+// of the first character that is not a cell, which is the length of the line
+// when it is too short and 81 when it is too long. `digits` is unspecified
+// after an error.
+// Runs 16 or 32 characters at a time with SSE2 or AVX2 when the CPU has them.
+int parse_puzzle_line(std::string_view line, std::span<uint8_t, 81> digits);
+
+// the implementations picked from, for tests and benchmarks. The vector ones
+// need a line of exactly 81 characters and a CPU with their instruction set.
+int parse_puzzle_line_scalar(std::string_view line, std::span<uint8_t, 81> digits);
+int parse_puzzle_line_sse2(std::string_view line, std::span<uint8_t, 81> digits);
+int parse_puzzle_line_avx2(std::string_view line, std::span<uint8_t, 81> digits);
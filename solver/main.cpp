@@ -1,25 +1,62 @@
 #include "ranges.h"
 #include "grid.h"
 #include "solver.h"
+#include "bitmask_solver.h"
+#include "dlx_solver.h"
+#include "band_solver.h"
+#include "batch.h"
+#include "parallel_solver.h"
+#include "generator.h"
+#include "canonical.h"
+#include "corpus.h"
+#include "solution_writer.h"
+#include "solve_limits.h"
 
 #include <fmt/format.h>
 
 #include <array>
+#include <charconv>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <optional>
 #include <string>
+#include <string_view>
+#include <unordered_set>
 
-void print_grid(Grid const& grid)
+template <int BoxW, int BoxH>
+void print_grid(BasicGrid<BoxW, BoxH> const& grid)
 {
-    constexpr auto line_fmt = "| {} {} {} | {} {} {} | {} {} {} |\n";
+    std::string text;
+    format_grid(grid, OutputFormat::pretty, text);
+    fmt::print("{}", text);
+}
 
-    for (auto lines : grid.chars() | views::chunk(9) | views::chunk(3))
-    {
-        fmt::print("{:->25}\n", "");
-        for (auto line : lines)
-        {
-            fmt::print(line_fmt, line[0], line[1], line[2], line[3], line[4], line[5], line[6], line[7], line[8]);
-        }
-    }
-    fmt::print("{:->25}\n", "");
+std::optional<OutputFormat> parse_format(std::string_view name)
+{
+    if (name == "compact")
+        return OutputFormat::compact;
+    if (name == "pretty")
+        return OutputFormat::pretty;
+    if (name == "binary")
+        return OutputFormat::binary;
+    return {};
+}
+
+// only builds with SUDOKU_STATS have anything to show.
+void print_stats([[maybe_unused]] SolverStats const& stats)
+{
+#if SUDOKU_STATS
+    fmt::print("{} decisions, {} backtracks, {} propagations, max depth {}.\n",
+               stats.decisions, stats.backtracks, stats.propagations, stats.max_depth);
+    fmt::print("setup {} us, search {} us, propagation {} us.\n",
+               stats.setup_ns / 1000, stats.search_ns / 1000, stats.propagate_ns / 1000);
+
+    fmt::print("decisions per depth:");
+    for (int64_t nodes : stats.depth_nodes)
+        fmt::print(" {}", nodes);
+    fmt::print("\n");
+#endif
 }
 
 std::array<int, 81> test_grid = 
@@ -37,25 +74,541 @@ std::array<int, 81> test_grid =
     0, 0, 9,  0, 0, 0,  0, 5, 4
 };
 
-int main(int argc, char *argv[])
+template <typename S, typename G, typename... Args>
+int run(G& grid, SolveLimits const& limits, Args&&... args)
 {
-    (void)argc, (void)argv;
+    using clock = std::chrono::steady_clock;
 
-    Grid grid;
-    grid.init(test_grid);
+    const auto start = clock::now();
+    S solver(grid, std::forward<Args>(args)...);
 
-    fmt::print("initial grid\n");
+    switch (solve_within(solver, limits).status)
+    {
+    case SolveStatus::solved:
+        break;
+    case SolveStatus::unsolvable:
+        fmt::print("\nno solution after {} steps.\n", solver.solve_steps_);
+        return 1;
+    case SolveStatus::timed_out:
+    case SolveStatus::budget_spent:
+    case SolveStatus::cancelled:
+        fmt::print("\ngave up after {} steps.\n", solver.solve_steps_);
+        print_stats(solver.stats_);
+        return 3;
+    }
+
+    const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(clock::now() - start);
+
+    fmt::print("\nfinal grid\n");
     print_grid(grid);
 
-    Solver solver(grid);
+    fmt::print("\nsolved in {} steps ({} us).\n", solver.solve_steps_, elapsed.count());
+    print_stats(solver.stats_);
+    return 0;
+}
+
+// bitmask search printing every placement as it happens, up to the first
+// solution. Every line printed costs more than a look at the limits.
+int run_trace(Grid& grid, BitmaskSolver::Options const& options, SolveLimits const& limits)
+{
+    constexpr std::string_view kinds[] = {"", "decide", "force", "", "remove"};
+
+    FrameArena arena;
+    BitmaskSolver solver(grid, options);
+
+    bool gave_up = false;
+    fmt::print("\n");
+    for (BitmaskSolver::Event const& e : solver.events(arena))
+    {
+        if (e.kind == BitmaskSolver::Event::solution)
+            break;
 
-    while (!solver.is_solved())
-        solver.solve_step();
+        fmt::print("{:<6} r{}c{} = {}\n", kinds[e.kind], e.idx / 9 + 1, e.idx % 9 + 1, e.val);
+
+        if (limits.spent(solver.solve_steps_) || limits.interrupted())
+        {
+            gave_up = true;
+            break;
+        }
+    }
+
+    if (!solver.is_solved())
+    {
+        if (gave_up)
+        {
+            fmt::print("\ngave up after {} steps.\n", solver.solve_steps_);
+            print_stats(solver.stats_);
+            return 3;
+        }
+
+        fmt::print("\nno solution after {} steps.\n", solver.solve_steps_);
+        return 1;
+    }
 
     fmt::print("\nfinal grid\n");
     print_grid(grid);
 
     fmt::print("\nsolved in {} steps.\n", solver.solve_steps_);
+    print_stats(solver.stats_);
+    return 0;
+}
+
+int run_parallel(Grid& grid, ParallelSolver::Options const& options, SolveLimits const& limits)
+{
+    using clock = std::chrono::steady_clock;
+
+    const auto start = clock::now();
+    ParallelSolver solver(grid, options);
+
+    if (!solver.solve(limits))
+    {
+        if (solver.status_ != SolveStatus::unsolvable)
+        {
+            fmt::print("\ngave up after {} steps.\n", solver.solve_steps_);
+            print_stats(solver.stats_);
+            return 3;
+        }
+
+        fmt::print("\nno solution after {} steps.\n", solver.solve_steps_);
+        return 1;
+    }
+
+    const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(clock::now() - start);
+
+    fmt::print("\nfinal grid\n");
+    print_grid(grid);
+
+    fmt::print("\nsolved in {} steps ({} us).\n", solver.solve_steps_, elapsed.count());
+    print_stats(solver.stats_);
+    return 0;
+}
+
+// prints what a count found; 3 when the limits stopped it first.
+int report_count(int64_t count, int64_t limit, bool finished)
+{
+    if (!finished)
+    {
+        fmt::print("\ngave up after {} solution(s), limit {}.\n", count, limit);
+        return 3;
+    }
+
+    fmt::print("\n{} solution(s) found, limit {}.\n", count, limit);
+    return 0;
+}
+
+std::optional<Engine> parse_engine(std::string_view name)
+{
+    if (name == "backtrack")
+        return Engine::backtrack;
+    if (name == "bitmask")
+        return Engine::bitmask;
+    if (name == "dlx")
+        return Engine::dlx;
+    if (name == "lanes")
+        return Engine::lanes;
+    if (name == "bands")
+        return Engine::bands;
+    return {};
+}
+
+int batch(std::string_view input, std::string_view output, BatchOptions const& options)
+{
+    MappedFile in;
+    if (!in.open(std::string(input)))
+    {
+        fmt::print(stderr, "can not open '{}'\n", input);
+        return 1;
+    }
+
+    std::ofstream file;
+    if (!output.empty())
+    {
+        file.open(std::string(output), std::ios::binary);
+        if (!file)
+        {
+            fmt::print(stderr, "can not open '{}'\n", output);
+            return 1;
+        }
+    }
+
+    const BatchReport report = solve_batch(in.text(), output.empty() ? std::cout : file, options);
+
+    fmt::print(stderr, "{} puzzles in {:.3f} s ({:.0f} puzzles/s), {} unsolved ({} over the limits).\n",
+               report.puzzles, report.seconds, report.puzzles / std::max(report.seconds, 1e-9), report.unsolved, report.stopped);
+
+    if (TranspositionTable const* table = options.bitmask.table)
+        fmt::print(stderr, "transposition table: {} entries, {} hits, {} misses, {} dead ends stored.\n",
+                   table->size(), report.table.hits, report.table.misses, report.table.stores);
+    return report.unsolved == 0 ? 0 : 1;
+}
+
+int generate(int64_t count, std::string_view output, GeneratorOptions const& options)
+{
+    using clock = std::chrono::steady_clock;
+
+    const auto start = clock::now();
+    const std::vector<Grid> puzzles = generate_puzzles(count, options);
+    const double seconds = std::chrono::duration<double>(clock::now() - start).count();
+
+    std::ofstream file;
+    if (!output.empty())
+    {
+        file.open(std::string(output), std::ios::binary);
+        if (!file)
+        {
+            fmt::print(stderr, "can not open '{}'\n", output);
+            return 1;
+        }
+    }
+
+    {
+        SolutionWriter writer(output.empty() ? std::cout : file, OutputFormat::compact);
+        for (Grid const& puzzle : puzzles)
+            writer.write(puzzle);
+    }
+
+    fmt::print(stderr, "{} puzzles generated in {:.3f} s ({:.0f} puzzles/s).\n", count, seconds, count / std::max(seconds, 1e-9));
+    return 0;
+}
+
+int canonicalize(std::string_view input, std::string_view output)
+{
+    using clock = std::chrono::steady_clock;
+
+    MappedFile in;
+    if (!in.open(std::string(input)))
+    {
+        fmt::print(stderr, "can not open '{}'\n", input);
+        return 1;
+    }
+
+    std::ofstream file;
+    if (!output.empty())
+    {
+        file.open(std::string(output), std::ios::binary);
+        if (!file)
+        {
+            fmt::print(stderr, "can not open '{}'\n", output);
+            return 1;
+        }
+    }
+
+    const auto start = clock::now();
+    int64_t count = 0, malformed = 0;
+    std::unordered_set<std::string> distinct;
+
+    {
+        SolutionWriter writer(output.empty() ? std::cout : file, OutputFormat::compact);
+
+        std::string_view text = in.text();
+        for (std::string_view record = next_record(text); !record.empty(); record = next_record(text))
+        {
+            ++count;
+
+            // a malformed line is written as an empty grid, as in batch mode.
+            Grid puzzle;
+            if (!puzzle.parse(record))
+            {
+                ++malformed;
+                writer.write(Grid{});
+                continue;
+            }
+
+            const Grid canonical = canonical_form(puzzle).grid;
+            writer.write(canonical);
+
+            std::string key;
+            format_grid(canonical, OutputFormat::compact, key);
+            distinct.insert(std::move(key));
+        }
+    }
+
+    const double seconds = std::chrono::duration<double>(clock::now() - start).count();
+    fmt::print(stderr, "{} puzzles in {:.3f} s, {} distinct up to symmetry, {} malformed.\n",
+               count, seconds, distinct.size(), malformed);
+    return malformed == 0 ? 0 : 1;
+}
+
+// single mode for the box sizes other than 3x3, which only the backtracking
+// and bitmask engines handle.
+template <int BoxW, int BoxH>
+int solve_sized(std::string_view puzzle, Engine engine, BitmaskSolver::Options const& options, int64_t count_limit,
+                SolveLimits const& limits)
+{
+    BasicGrid<BoxW, BoxH> grid;
+    if (!grid.parse(puzzle))
+    {
+        fmt::print(stderr, "puzzle is not a {0}x{0} grid\n", BoxW * BoxH);
+        return 2;
+    }
+
+    fmt::print("initial grid\n");
+    print_grid(grid);
+
+    if (count_limit > 0)
+    {
+        BasicBitmaskSolver<BoxW, BoxH> solver(grid, options);
+        const int64_t count = solver.count_solutions(count_limit, limits);
+        return report_count(count, count_limit, count == count_limit || solver.is_unsolvable());
+    }
+
+    switch (engine)
+    {
+    case Engine::backtrack:
+        return run<BasicSolver<BoxW, BoxH>>(grid, limits);
+    case Engine::bitmask:
+        return run<BasicBitmaskSolver<BoxW, BoxH>>(grid, limits, options);
+    case Engine::lanes:
+        // main() refuses lanes outside --batch.
+        return 2;
+    case Engine::dlx:
+    case Engine::bands:
+        break;
+    }
+
+    fmt::print(stderr, "the dlx and bands engines only solve 3x3 boxes\n");
+    return 2;
+}
+
+int main(int argc, char *argv[])
+{
+    constexpr auto usage =
+        "usage: {} [--engine backtrack|bitmask|dlx|lanes|bands] [--select in-order|mrv] [--propagate|--no-propagate]\n"
+        "          [--parallel] [--threads <n>] [--count <limit>] [--batch <puzzles file> [--output <file>] [--format compact|pretty|binary]]\n"
+        "          [--generate <n> [--seed <seed>] [--output <file>]] [--canonical <puzzles file> [--output <file>]]\n"
+        "          [--box <w>x<h>] [--puzzle <cells>] [--trace]\n"
+        "          [--timeout <ms>] [--max-steps <n>] [--table <entries>]\n";
+
+    std::optional<Engine> engine;
+    std::optional<OutputFormat> format;
+    std::optional<BitmaskSolver::Selection> selection;
+    std::optional<bool> propagate;
+    std::string_view input, canonical_input, output, puzzle;
+    int box_w = 3, box_h = 3;
+    unsigned threads = 0;
+    bool parallel = false;
+    bool trace = false;
+    int64_t count_limit = 0;
+    int64_t timeout_ms = 0;
+    int64_t max_steps = 0;
+    size_t table_entries = 0;
+    int64_t generate_count = 0;
+    uint64_t seed = 0;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string_view arg = argv[i];
+        std::string_view value = (i + 1 < argc) ? argv[i + 1] : "";
+        bool valid = true;
+
+        if (arg == "--engine")
+            valid = (engine = parse_engine(value)).has_value();
+        else if (arg == "--format")
+            valid = (format = parse_format(value)).has_value();
+        else if (arg == "--select")
+        {
+            valid = (value == "in-order" || value == "mrv");
+            selection = (value == "mrv") ? BitmaskSolver::Selection::mrv : BitmaskSolver::Selection::in_order;
+        }
+        else if (arg == "--box")
+        {
+            const char* last = value.data() + value.size();
+            auto [end, ec] = std::from_chars(value.data(), last, box_w);
+            valid = ec == std::errc{} && end != last && *end == 'x';
+            if (valid)
+            {
+                auto [height_end, height_ec] = std::from_chars(end + 1, last, box_h);
+                valid = height_ec == std::errc{} && height_end == last;
+            }
+        }
+        else if (arg == "--puzzle")
+            valid = !(puzzle = value).empty();
+        else if (arg == "--batch")
+            valid = !(input = value).empty();
+        else if (arg == "--canonical")
+            valid = !(canonical_input = value).empty();
+        else if (arg == "--output")
+            valid = !(output = value).empty();
+        else if (arg == "--count")
+            valid = std::from_chars(value.data(), value.data() + value.size(), count_limit).ec == std::errc{} && count_limit > 0;
+        else if (arg == "--timeout")
+            valid = std::from_chars(value.data(), value.data() + value.size(), timeout_ms).ec == std::errc{} && timeout_ms > 0;
+        else if (arg == "--max-steps")
+            valid = std::from_chars(value.data(), value.data() + value.size(), max_steps).ec == std::errc{} && max_steps > 0;
+        else if (arg == "--table")
+            valid = std::from_chars(value.data(), value.data() + value.size(), table_entries).ec == std::errc{} && table_entries > 0;
+        else if (arg == "--generate")
+            valid = std::from_chars(value.data(), value.data() + value.size(), generate_count).ec == std::errc{} && generate_count > 0;
+        else if (arg == "--seed")
+            valid = std::from_chars(value.data(), value.data() + value.size(), seed).ec == std::errc{};
+        else if (arg == "--threads")
+            valid = std::from_chars(value.data(), value.data() + value.size(), threads).ec == std::errc{};
+        else if (arg == "--propagate" || arg == "--no-propagate")
+        {
+            propagate = (arg == "--propagate");
+            continue;
+        }
+        else if (arg == "--parallel")
+        {
+            parallel = true;
+            continue;
+        }
+        else if (arg == "--trace")
+        {
+            trace = true;
+            continue;
+        }
+        else
+            valid = false;
+
+        if (!valid)
+        {
+            fmt::print(usage, argv[0]);
+            return 2;
+        }
+
+        ++i;
+    }
+
+    bool box_supported = false;
+#define SUDOKU_SUPPORTED(W, H) box_supported = box_supported || (box_w == W && box_h == H);
+    SUDOKU_BOX_SIZES(SUDOKU_SUPPORTED)
+#undef SUDOKU_SUPPORTED
+
+    if (!box_supported)
+    {
+#define SUDOKU_NAME(W, H) " " #W "x" #H
+        fmt::print(stderr, "unsupported box size {}x{}, the engines are built for{}\n", box_w, box_h, SUDOKU_BOX_SIZES(SUDOKU_NAME));
+#undef SUDOKU_NAME
+        return 2;
+    }
+
+    // one search never comes back to a state, only the puzzles of a batch
+    // share dead ends.
+    if (table_entries > 0 && input.empty())
+    {
+        fmt::print(stderr, "--table only applies to --batch\n");
+        return 2;
+    }
+
+    // the lanes only pay off across many puzzles, a single one would just
+    // run on the bitmask engine.
+    if (engine == Engine::lanes && input.empty())
+    {
+        fmt::print(stderr, "--engine lanes only applies to --batch\n");
+        return 2;
+    }
+
+    if (generate_count > 0)
+        return generate(generate_count, output, GeneratorOptions{seed, threads});
+
+    if (!canonical_input.empty())
+        return canonicalize(canonical_input, output);
+
+    if (!input.empty())
+    {
+        BatchOptions options;
+        options.engine = engine.value_or(options.engine);
+        options.bitmask.selection = selection.value_or(options.bitmask.selection);
+        options.bitmask.propagate = propagate.value_or(options.bitmask.propagate);
+        options.threads = threads;
+        options.format = format.value_or(options.format);
+        options.puzzle_timeout = std::chrono::milliseconds(timeout_ms);
+        options.max_steps = max_steps;
+
+        std::optional<TranspositionTable> table;
+        if (table_entries > 0)
+            options.bitmask.table = &table.emplace(table_entries);
+
+        return batch(input, output, options);
+    }
+
+    SolveLimits limits = timeout_ms > 0 ? SolveLimits::within(std::chrono::milliseconds(timeout_ms)) : SolveLimits{};
+    limits.max_steps = max_steps;
+
+    BitmaskSolver::Options bitmask_options;
+    bitmask_options.selection = selection.value_or(bitmask_options.selection);
+    bitmask_options.propagate = propagate.value_or(bitmask_options.propagate);
+
+    if (box_w != 3 || box_h != 3)
+    {
+        if (parallel || puzzle.empty())
+        {
+            fmt::print(usage, argv[0]);
+            return 2;
+        }
+
+#define SUDOKU_DISPATCH(W, H)                                                                              \
+        if (box_w == W && box_h == H)                                                                      \
+            return solve_sized<W, H>(puzzle, engine.value_or(Engine::backtrack), bitmask_options, count_limit, limits);
+        SUDOKU_BOX_SIZES(SUDOKU_DISPATCH)
+#undef SUDOKU_DISPATCH
+    }
+
+    Grid grid;
+    if (puzzle.empty())
+        grid.init(test_grid);
+    else if (!grid.parse(puzzle))
+    {
+        fmt::print(stderr, "puzzle is not a 9x9 grid\n");
+        return 2;
+    }
+
+    fmt::print("initial grid\n");
+    print_grid(grid);
+
+    if (count_limit > 0)
+    {
+        if (parallel)
+        {
+            ParallelSolver::Options options;
+            options.bitmask.selection = selection.value_or(options.bitmask.selection);
+            options.bitmask.propagate = propagate.value_or(options.bitmask.propagate);
+            options.threads = threads;
+
+            ParallelSolver solver(grid, options);
+            const int64_t count = solver.count_solutions(count_limit, limits);
+            return report_count(count, count_limit, solver.status_ == SolveStatus::solved || solver.status_ == SolveStatus::unsolvable);
+        }
+
+        BitmaskSolver solver(grid, bitmask_options);
+        const int64_t count = solver.count_solutions(count_limit, limits);
+        return report_count(count, count_limit, count == count_limit || solver.is_unsolvable());
+    }
+
+    if (parallel)
+    {
+        ParallelSolver::Options options;
+        options.bitmask.selection = selection.value_or(options.bitmask.selection);
+        options.bitmask.propagate = propagate.value_or(options.bitmask.propagate);
+        options.threads = threads;
+
+        return run_parallel(grid, options, limits);
+    }
+
+    if (trace)
+        return run_trace(grid, bitmask_options, limits);
+
+    int result = 0;
+    switch (engine.value_or(Engine::backtrack))
+    {
+    case Engine::backtrack:
+        result = run<Solver>(grid, limits);
+        break;
+    case Engine::bitmask:
+        result = run<BitmaskSolver>(grid, limits, bitmask_options);
+        break;
+    case Engine::lanes:
+        // refused above without --batch.
+        result = 2;
+        break;
+    case Engine::dlx:
+        result = run<DlxSolver>(grid, limits);
+        break;
+    case Engine::bands:
+        result = run<BandSolver>(grid, limits);
+        break;
+    }
 
 #if 0
     auto print_zone = [] (auto&& r, std::string_view name, int idx) 
@@ -71,5 +624,5 @@ int main(int argc, char *argv[])
     print_zone(grid.zone(0) | ranges::views::transform(as_char), "zone", 0);
 #endif
 
-    return 0;
+    return result;
 }
@@ -0,0 +1,347 @@
+#include "parallel_solver.h"
+#include "grid.h"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <deque>
+#include <limits>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    // a subtree of the search. The key holds the index of the candidate
+    // taken at each depth, 4 bits per level from the most significant end,
+    // so comparing keys compares positions in depth first order.
+    struct Task
+    {
+        PackedGrid grid;
+        uint64_t key = 0;
+        int depth = 0;
+    };
+
+    constexpr int key_bits = 4;
+    constexpr int max_split_depth = 64 / key_bits - 1;
+
+    constexpr uint64_t child_key(uint64_t key, int depth, int branch)
+    {
+        return key | (uint64_t(branch) << (64 - key_bits * (depth + 1)));
+    }
+
+    // steps between checks that an earlier subtree has not already been
+    // solved, that the solutions counted have reached the limit, or that the
+    // search is out of limits.
+    constexpr int64_t abort_check_interval = 1024;
+
+    class WorkDeque
+    {
+    public:
+        void push(Task&& task)
+        {
+            std::lock_guard lock(mutex_);
+            tasks_.push_back(std::move(task));
+        }
+
+        // owner end: the deepest, most recently split task.
+        std::optional<Task> pop()
+        {
+            std::lock_guard lock(mutex_);
+            if (tasks_.empty())
+                return {};
+
+            Task task = std::move(tasks_.back());
+            tasks_.pop_back();
+            return task;
+        }
+
+        // thief end: the shallowest task, which has the largest subtree.
+        std::optional<Task> steal()
+        {
+            std::lock_guard lock(mutex_);
+            if (tasks_.empty())
+                return {};
+
+            Task task = std::move(tasks_.front());
+            tasks_.pop_front();
+            return task;
+        }
+
+    private:
+        std::mutex mutex_;
+        std::deque<Task> tasks_;
+    };
+
+    class Search
+    {
+    public:
+        // a positive `limit` counts solutions up to it instead of keeping one.
+        Search(ParallelSolver::Options const& options, SolveLimits const& limits, unsigned threads, int64_t limit = 0)
+            : options_(options)
+            , limits_(limits)
+            , deques_(threads)
+            , limit_(limit)
+        {
+        }
+
+        void run(Grid const& grid)
+        {
+            pending_ = 1;
+            deques_[0].push(Task{PackedGrid(grid)});
+
+            std::vector<std::jthread> pool;
+            for (unsigned t = 1; t < deques_.size(); ++t)
+                pool.emplace_back([this, t] { work(t); });
+            work(0);
+        }
+
+        bool solved() const { return best_key_.load() != no_solution; }
+        PackedGrid const& solution() const { return solution_; }
+        int64_t steps() const { return steps_.load(); }
+        SolverStats const& stats() const { return stats_; }
+        int64_t count() const { return found_.load(); }
+
+        // why the search stopped early, nullopt when it ran to its end.
+        std::optional<SolveStatus> stopped() const
+        {
+            return stopped_.load() ? std::optional(stop_reason_) : std::nullopt;
+        }
+
+    private:
+        static constexpr uint64_t no_solution = std::numeric_limits<uint64_t>::max();
+
+        void work(unsigned self)
+        {
+            while (pending_.load() != 0)
+            {
+                std::optional<Task> task = deques_[self].pop();
+                for (unsigned i = 1; !task && i < deques_.size(); ++i)
+                    task = deques_[(self + i) % deques_.size()].steal();
+
+                if (!task)
+                {
+                    std::this_thread::yield();
+                    continue;
+                }
+
+                process(self, *task);
+                --pending_;
+            }
+        }
+
+        void process(unsigned self, Task& task)
+        {
+            // a later subtree than the best solution can not hold an earlier one.
+            if (limit_ > 0 ? found_.load() >= limit_ : task.key > best_key_.load())
+                return;
+
+            int64_t none = 0;
+            if (over_limits(none))
+                return;
+
+            Grid grid;
+            task.grid.unpack(grid);
+
+            BitmaskSolver solver(grid, options_.bitmask);
+
+            if (task.depth < options_.split_depth && solver.branch_cell() != -1)
+            {
+                const int idx = solver.branch_cell();
+                uint16_t cands = solver.candidates(idx);
+
+                // children start from the propagated grid.
+                const PackedGrid snapshot(grid);
+
+                // pushed last to first so the owner pops them in search order.
+                for (int branch = std::popcount(cands) - 1; branch >= 0; --branch)
+                {
+                    const uint16_t bit = uint16_t(std::bit_floor(cands));
+                    cands &= uint16_t(~bit);
+
+                    Task child{snapshot, child_key(task.key, task.depth, branch), task.depth + 1};
+                    child.grid.set(idx, uint8_t(std::countr_zero(bit) + 1));
+
+                    ++pending_;
+                    deques_[self].push(std::move(child));
+                }
+
+                SUDOKU_STAT(add_stats(solver.stats_));
+                return;
+            }
+
+            if (limit_ > 0)
+            {
+                count_subtree(solver);
+                return;
+            }
+
+            int64_t steps = 0;
+            while (!solver.is_solved() && !solver.is_unsolvable())
+            {
+                solver.solve_step();
+
+                if (++steps == abort_check_interval && (over_limits(steps) || task.key > best_key_.load()))
+                    break;
+            }
+            steps_ += steps;
+            SUDOKU_STAT(add_stats(solver.stats_));
+
+            if (solver.is_solved())
+                offer(task.key, grid);
+        }
+
+        // counts the solutions of a subtree one at a time, each taken from
+        // what is left below the limit, and stops once the other workers have
+        // reached it.
+        void count_subtree(BitmaskSolver& solver)
+        {
+            int64_t steps = 0;
+            while (!solver.is_unsolvable())
+            {
+                if (solver.is_solved())
+                {
+                    if (!claim_solution())
+                        break;
+
+                    solver.skip_solution();
+                    continue;
+                }
+
+                solver.solve_step();
+
+                if (++steps == abort_check_interval && (over_limits(steps) || found_.load() >= limit_))
+                    break;
+            }
+            steps_ += steps;
+            SUDOKU_STAT(add_stats(solver.stats_));
+        }
+
+        // Adds the `steps` taken since the last look to the total and tells
+        // whether the search is out of limits, in which case every worker
+        // drops what it has left.
+        bool over_limits(int64_t& steps)
+        {
+            const int64_t total = steps != 0 ? steps_ += steps : steps_.load();
+            steps = 0;
+
+            if (stopped_.load())
+                return true;
+
+            std::optional<SolveStatus> reason = limits_.interrupted();
+            if (!reason && limits_.spent(total))
+                reason = SolveStatus::budget_spent;
+
+            if (reason && !stopped_.exchange(true))
+                stop_reason_ = *reason;
+            return reason.has_value();
+        }
+
+        // false when the limit was already reached.
+        bool claim_solution()
+        {
+            int64_t found = found_.load();
+            while (found < limit_ && !found_.compare_exchange_weak(found, found + 1))
+            {
+            }
+            return found < limit_;
+        }
+
+        void add_stats(SolverStats const& stats)
+        {
+            std::lock_guard lock(stats_mutex_);
+            stats_ += stats;
+        }
+
+        void offer(uint64_t key, Grid const& grid)
+        {
+            std::lock_guard lock(solution_mutex_);
+            if (key < best_key_.load())
+            {
+                solution_.pack(grid);
+                best_key_ = key;
+            }
+        }
+
+        ParallelSolver::Options const& options_;
+        SolveLimits const& limits_;
+        std::vector<WorkDeque> deques_;
+        std::atomic<int64_t> pending_ = 0;
+        std::atomic<int64_t> steps_ = 0;
+
+        std::mutex stats_mutex_;
+        SolverStats stats_;
+
+        const int64_t limit_;
+        std::atomic<int64_t> found_ = 0;
+
+        // set by the first worker to find the limits spent; the reason is
+        // read once the workers are joined.
+        std::atomic<bool> stopped_ = false;
+        SolveStatus stop_reason_ = SolveStatus::cancelled;
+
+        std::atomic<uint64_t> best_key_ = no_solution;
+        std::mutex solution_mutex_;
+        PackedGrid solution_;
+    };
+}
+
+ParallelSolver::ParallelSolver(Grid& grid) : ParallelSolver(grid, Options{})
+{
+}
+
+ParallelSolver::ParallelSolver(Grid& grid, Options options)
+    : grid_(grid)
+    , options_(options)
+{
+    options_.split_depth = std::clamp(options_.split_depth, 0, max_split_depth);
+}
+
+bool ParallelSolver::solve(SolveLimits const& limits)
+{
+    const unsigned threads = options_.threads ? options_.threads : std::max(1u, std::thread::hardware_concurrency());
+
+    Search search(options_, limits, threads);
+    search.run(grid_);
+    solve_steps_ = search.steps();
+    stats_ = search.stats();
+
+    // a stop drops subtrees, so a solution found before it may not be the
+    // first in search order and is not kept.
+    if (const std::optional<SolveStatus> reason = search.stopped())
+    {
+        status_ = *reason;
+        return false;
+    }
+
+    status_ = search.solved() ? SolveStatus::solved : SolveStatus::unsolvable;
+    if (!search.solved())
+        return false;
+
+    // keep the givens flags of the original grid.
+    for (Grid::Cell& c : grid_.cells())
+        c.set(search.solution().val(c.idx_));
+
+    return true;
+}
+
+int64_t ParallelSolver::count_solutions(int64_t limit, SolveLimits const& limits)
+{
+    if (limit <= 0)
+        return 0;
+
+    const unsigned threads = options_.threads ? options_.threads : std::max(1u, std::thread::hardware_concurrency());
+
+    Search search(options_, limits, threads, limit);
+    search.run(grid_);
+    solve_steps_ = search.steps();
+    stats_ = search.stats();
+
+    if (search.count() == limit)
+        status_ = SolveStatus::solved;
+    else
+        status_ = search.stopped().value_or(SolveStatus::unsolvable);
+
+    return search.count();
+}
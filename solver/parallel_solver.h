@@ -0,0 +1,53 @@
+#pragma once
+
+#include "bitmask_solver.h"
+#include "solve_limits.h"
+
+#include <cstdint>
+
+// Splits the bitmask search of one grid into subtrees spread over worker
+// threads. Each worker owns a deque of tasks and steals the shallowest task
+// of another worker when its own runs dry. Subtrees are keyed by their path
+// from the root, so the solution kept is the first one in sequential search
+// order and matches BitmaskSolver with the same options.
+class ParallelSolver
+{
+public:
+    struct Options
+    {
+        BitmaskSolver::Options bitmask = {BitmaskSolver::Selection::mrv, true};
+
+        // worker threads, 0 for one per hardware thread.
+        unsigned threads = 0;
+
+        // decisions below which subtrees become separate tasks, at most 15.
+        int split_depth = 6;
+    };
+
+    ParallelSolver(Grid& grid);
+    ParallelSolver(Grid& grid, Options options);
+
+    // Fills the grid with the solution and returns true, or leaves it
+    // untouched and returns false when there is none or `limits` ran out
+    // first. The step budget counts the steps of all workers together and
+    // every worker looks at the limits every few thousand steps, so a
+    // search may overrun them by that much per thread.
+    bool solve(SolveLimits const& limits = {});
+
+    // number of solutions, up to `limit` or as many as were found before
+    // `limits` ran out; the grid is left untouched.
+    int64_t count_solutions(int64_t limit, SolveLimits const& limits = {});
+
+    // steps and statistics of all workers together.
+    int64_t solve_steps_ = 0;
+    SolverStats stats_;
+
+    // how the last search ended: solved when it kept a solution or counted
+    // up to the limit, unsolvable when it ran out of subtrees, otherwise the
+    // limit that stopped it.
+    SolveStatus status_ = SolveStatus::unsolvable;
+
+private:
+    Grid& grid_;
+    Options options_;
+};
@@ -0,0 +1,115 @@
+#include "solution_writer.h"
+
+#include <algorithm>
+#include <ostream>
+
+template <int BoxW, int BoxH>
+void format_grid(BasicGrid<BoxW, BoxH> const& grid, OutputFormat format, std::string& out)
+{
+    using grid_t = BasicGrid<BoxW, BoxH>;
+    constexpr int size = grid_t::size;
+
+    auto cells = grid.cells();
+
+    switch (format)
+    {
+    case OutputFormat::compact:
+    {
+        const size_t start = out.size();
+        out.resize(start + cells.size() + 1);
+
+        char* p = out.data() + start;
+        for (auto const& c : cells)
+            *p++ = (c.val() != 0) ? grid_t::digit_char(c.val()) : '.';
+        *p = '\n';
+        break;
+    }
+    case OutputFormat::pretty:
+    {
+        // "| a b c " per box and the closing '|' of each row.
+        constexpr size_t width = BoxH * (2 * BoxW + 2) + 1;
+        constexpr size_t rules = BoxW + 1;
+
+        const size_t start = out.size();
+        out.resize(start + (size + rules) * (width + 1));
+
+        char* p = out.data() + start;
+        auto rule = [&p]
+        {
+            p = std::fill_n(p, width, '-');
+            *p++ = '\n';
+        };
+
+        for (int row = 0; row < size; ++row)
+        {
+            if (row % BoxH == 0)
+                rule();
+
+            for (int col = 0; col < size; ++col)
+            {
+                if (col % BoxW == 0)
+                {
+                    *p++ = '|';
+                    *p++ = ' ';
+                }
+                *p++ = cells[row * size + col].as_char();
+                *p++ = ' ';
+            }
+            *p++ = '|';
+            *p++ = '\n';
+        }
+        rule();
+        break;
+    }
+    case OutputFormat::binary:
+    {
+        const size_t start = out.size();
+        out.resize(start + cells.size());
+
+        char* p = out.data() + start;
+        for (auto const& c : cells)
+            *p++ = char(c.val());
+        break;
+    }
+    }
+}
+
+#define SUDOKU_INSTANTIATE(W, H) template void format_grid(BasicGrid<W, H> const&, OutputFormat, std::string&);
+SUDOKU_BOX_SIZES(SUDOKU_INSTANTIATE)
+#undef SUDOKU_INSTANTIATE
+
+SolutionWriter::SolutionWriter(std::ostream& out, OutputFormat format)
+    : out_(out)
+    , format_(format)
+{
+    buffer_.reserve(flush_size + 4096);
+}
+
+SolutionWriter::~SolutionWriter()
+{
+    flush();
+}
+
+void SolutionWriter::write_formatted(std::string_view records)
+{
+    // large runs skip the copy into the buffer.
+    if (records.size() >= flush_size)
+    {
+        flush();
+        out_.write(records.data(), (std::streamsize)records.size());
+        return;
+    }
+
+    buffer_ += records;
+    if (buffer_.size() >= flush_size)
+        flush();
+}
+
+void SolutionWriter::flush()
+{
+    if (buffer_.empty())
+        return;
+
+    out_.write(buffer_.data(), (std::streamsize)buffer_.size());
+    buffer_.clear();
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "grid.h"
+
+#include <cstddef>
+#include <iosfwd>
+#include <string>
+#include <string_view>
+
+enum class OutputFormat
+{
+    compact, // one line of digits per grid, '.' for blanks
+    pretty,  // rows with box separators, followed by an empty line
+    binary,  // one byte per cell, 0 for blanks
+};
+
+// Appends a grid to `out`. The pretty layout ends with the closing rule and
+// no empty line, as printed in single mode.
+template <int BoxW, int BoxH>
+void format_grid(BasicGrid<BoxW, BoxH> const& grid, OutputFormat format, std::string& out);
+
+// Appends a grid as one record of a stream of grids in `format`.
+template <int BoxW, int BoxH>
+void format_record(BasicGrid<BoxW, BoxH> const& grid, OutputFormat format, std::string& out)
+{
+    format_grid(grid, format, out);
+    if (format == OutputFormat::pretty)
+        out += '\n';
+}
+
+// Formats grids into one reused buffer and hands it to the stream in large
+// writes, so output costs a write call per megabyte rather than per line.
+class SolutionWriter
+{
+public:
+    static constexpr size_t flush_size = size_t(1) << 20;
+
+    SolutionWriter(std::ostream& out, OutputFormat format);
+    ~SolutionWriter();
+
+    SolutionWriter(SolutionWriter const&) = delete;
+    SolutionWriter& operator=(SolutionWriter const&) = delete;
+
+    template <int BoxW, int BoxH>
+    void write(BasicGrid<BoxW, BoxH> const& grid)
+    {
+        format_record(grid, format_, buffer_);
+        if (buffer_.size() >= flush_size)
+            flush();
+    }
+
+    // records already formatted in this writer's format.
+    void write_formatted(std::string_view records);
+
+    void flush();
+
+    OutputFormat format() const { return format_; }
+
+private:
+    std::ostream& out_;
+    OutputFormat format_;
+    std::string buffer_;
+};
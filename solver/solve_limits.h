@@ -0,0 +1,107 @@
+#pragma once
+
+#include "solver_stats.h"
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <stop_token>
+
+enum class SolveStatus
+{
+    solved,
+    unsolvable,
+    timed_out,    // the deadline passed
+    budget_spent, // `max_steps` steps without an answer
+    cancelled,    // a stop was requested through the token
+};
+
+// Bounds on one solve. The default limits nothing.
+struct SolveLimits
+{
+    using clock = std::chrono::steady_clock;
+
+    clock::time_point deadline = clock::time_point::max();
+
+    // search steps, 0 for no budget.
+    int64_t max_steps = 0;
+
+    std::stop_token stop;
+
+    // a deadline `timeout` from now.
+    static SolveLimits within(std::chrono::nanoseconds timeout)
+    {
+        SolveLimits limits;
+        limits.deadline = clock::now() + timeout;
+        return limits;
+    }
+
+    // true once `steps` steps have used up the budget.
+    bool spent(int64_t steps) const { return max_steps > 0 && steps >= max_steps; }
+
+    // why a search has to stop when a stop was requested or the deadline
+    // passed. Reads the clock, so loops only ask every few steps.
+    std::optional<SolveStatus> interrupted() const
+    {
+        if (stop.stop_requested())
+            return SolveStatus::cancelled;
+        if (deadline != clock::time_point::max() && clock::now() >= deadline)
+            return SolveStatus::timed_out;
+        return {};
+    }
+};
+
+struct SolveResult
+{
+    SolveStatus status = SolveStatus::unsolvable;
+    int64_t steps = 0;  // steps taken by this call
+    SolverStats stats; // the engine's statistics when it returned
+};
+
+// Steps taken between two looks at the clock and the stop token. A step is a
+// few hundred nanoseconds at most, so a limit is noticed within tens of
+// microseconds while the checks stay out of the profile.
+inline constexpr int64_t limit_check_steps = 64;
+
+// Runs solve_step() on any engine until it is solved, unsolvable or out of
+// limits. The engine is left as it stopped, so a timed out solve can be
+// resumed by calling this again with new limits.
+template <typename S>
+SolveResult solve_within(S& solver, SolveLimits const& limits)
+{
+    SolveResult result;
+
+    for (;;)
+    {
+        if (solver.is_solved())
+        {
+            result.status = SolveStatus::solved;
+            break;
+        }
+        if (solver.is_unsolvable())
+        {
+            result.status = SolveStatus::unsolvable;
+            break;
+        }
+        if (limits.spent(result.steps))
+        {
+            result.status = SolveStatus::budget_spent;
+            break;
+        }
+
+        if (result.steps % limit_check_steps == 0)
+        {
+            if (const std::optional<SolveStatus> reason = limits.interrupted())
+            {
+                result.status = *reason;
+                break;
+            }
+        }
+
+        solver.solve_step();
+        ++result.steps;
+    }
+
+    result.stats = solver.stats_;
+    return result;
+}
@@ -1,67 +1,99 @@
 #include "solver.h"
 #include "grid.h"
 
-#include <fmt/format.h>
-
 #include <iterator>
 
 
 namespace 
 {
-    using Cell = Grid::Cell;
-    
-    bool check_unique(int idx, uint8_t value, Grid& grid)
+    template <int BoxW, int BoxH>
+    bool check_unique(int idx, uint8_t value, BasicGrid<BoxW, BoxH>& grid)
     {
-        const int row_idx = idx / 9;
-        auto row = grid.row(row_idx);
-        
-        const int col_idx = idx % 9;
-        auto col = grid.col(col_idx);
+        using Cell = typename BasicGrid<BoxW, BoxH>::Cell;
 
-        auto zone = grid.zone_of(grid.cells()[idx]);
+        const auto units = BasicTopology<BoxW, BoxH>::units_of[idx];
 
         auto check = [=](Cell const& cell) { return cell.val() == value; };
 
-        return ranges::none_of(row, check)
-            && ranges::none_of(col, check)
-            && ranges::none_of(zone.value(), check);
+        return ranges::none_of(grid.row(units.row), check)
+            && ranges::none_of(grid.col(units.col), check)
+            && ranges::none_of(grid.zone(units.box), check);
     }
 
-    int try_set_or_backtrack(Cell& cell, Grid& grid)
+    // first value above `from` that fits the cell, or 0 when there is none.
+    template <int BoxW, int BoxH>
+    uint8_t next_unique(int idx, uint8_t from, BasicGrid<BoxW, BoxH>& grid)
     {
-        for (uint8_t val = cell.val() + 1; val <= 9; ++val)
+        for (uint8_t val = from + 1; val <= BasicGrid<BoxW, BoxH>::size; ++val)
         {
-            if (check_unique(cell.idx_, val, grid))
-            {
-                cell.set(val);
-                return cell.idx_;
-            }
+            if (check_unique(idx, val, grid))
+                return val;
         }
 
-        cell.set(0);
-
-        Cell& prev = grid.cells()[grid.prev_idx(cell.idx_)];
-        return try_set_or_backtrack(prev, grid);
+        return 0;
     }
 }
 
-Solver::Solver(Grid& grid) : grid_(grid)
+template <int BoxW, int BoxH>
+BasicSolver<BoxW, BoxH>::BasicSolver(grid_t& grid) : grid_(grid)
 {
+    SUDOKU_PHASE(stats_.setup_ns);
     next_idx_ = grid_.next_idx(-1);
 }
 
-void Solver::solve_step()
+template <int BoxW, int BoxH>
+void BasicSolver<BoxW, BoxH>::solve_step()
 {
-    Cell& cell = grid_.cells()[next_idx_];
+    if (next_idx_ == -1)
+        return;
+
+    SUDOKU_PHASE(stats_.search_ns);
+
+    int idx = next_idx_;
+    uint8_t from = 0;
+
+    for (;;)
+    {
+        auto& cell = grid_.cells()[idx];
+        cell.set(0);
+
+        if (uint8_t val = next_unique(idx, from, grid_); val != 0)
+        {
+            cell.set(val);
+            SUDOKU_STAT(stats_.record_decision(depth_));
+            trail_[depth_++] = {typename topology::index_t(idx), val};
+            break;
+        }
 
-    cell.set(0);
-    int last_set_idx = try_set_or_backtrack(cell, grid_);
+        if (depth_ == 0)
+        {
+            unsolvable_ = true;
+            next_idx_ = -1;
+            return;
+        }
+
+        const Decision prev = trail_[--depth_];
+        SUDOKU_STAT(++stats_.backtracks);
+        idx = prev.idx;
+        from = prev.val;
+    }
 
-    next_idx_ = grid_.next_idx(last_set_idx);
+    next_idx_ = grid_.next_idx(idx);
     ++solve_steps_;
 }
 
-bool Solver::is_solved() const
+template <int BoxW, int BoxH>
+bool BasicSolver<BoxW, BoxH>::is_solved() const
 {
-    return next_idx_ == -1;
-}
\ No newline at end of file
+    return next_idx_ == -1 && !unsolvable_;
+}
+
+template <int BoxW, int BoxH>
+bool BasicSolver<BoxW, BoxH>::is_unsolvable() const
+{
+    return unsolvable_;
+}
+
+#define SUDOKU_INSTANTIATE(W, H) template class BasicSolver<W, H>;
+SUDOKU_BOX_SIZES(SUDOKU_INSTANTIATE)
+#undef SUDOKU_INSTANTIATE
@@ -1,20 +1,42 @@
 #pragma once
 
-#include <cstdint>
+#include "grid.h"
+#include "solver_stats.h"
 
-class Grid;
+#include <array>
+#include <cstdint>
 
-class Solver
+template <int BoxW, int BoxH>
+class BasicSolver
 {
 public:
-    Solver(Grid& grid);
+    using grid_t = BasicGrid<BoxW, BoxH>;
+
+    BasicSolver(grid_t& grid);
 
     void solve_step();
     bool is_solved() const;
+    bool is_unsolvable() const;
 
     int64_t solve_steps_ = 0;
+    SolverStats stats_;
 
 private:
-    Grid& grid_;
+    using topology = typename grid_t::topology;
+
+    struct Decision
+    {
+        typename topology::index_t idx;
+        uint8_t val;
+    };
+
+    grid_t& grid_;
     int next_idx_ = 0;
+    bool unsolvable_ = false;
+
+    // every value placed by the search, in order; backtracking pops from the back.
+    std::array<Decision, topology::cell_count> trail_ = {};
+    int depth_ = 0;
 };
+
+using Solver = BasicSolver<3, 3>;
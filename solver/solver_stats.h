@@ -0,0 +1,92 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+#ifndef SUDOKU_STATS
+#define SUDOKU_STATS 0
+#endif
+
+// Search statistics the engines keep next to solve_steps_. They are only
+// recorded in builds with SUDOKU_STATS=1 (the SUDOKU_STATS CMake option);
+// otherwise the struct is empty and every SUDOKU_STAT and SUDOKU_PHASE
+// compiles to nothing.
+struct SolverStats
+{
+    static constexpr bool enabled = SUDOKU_STATS != 0;
+
+#if SUDOKU_STATS
+    int64_t decisions = 0;    // values tried by guessing
+    int64_t backtracks = 0;   // guessed values taken back
+    int64_t propagations = 0; // values forced by constraint propagation
+    int max_depth = 0;        // most guesses stacked at once
+
+    // guesses tried at each depth, 0 for the first one.
+    std::vector<int64_t> depth_nodes;
+
+    // time in the constructor and in solve steps, both including the time
+    // they spend propagating.
+    int64_t setup_ns = 0;
+    int64_t search_ns = 0;
+    int64_t propagate_ns = 0;
+
+    // a guess made with `depth` others already on the stack.
+    void record_decision(int depth)
+    {
+        ++decisions;
+        if (depth >= (int)depth_nodes.size())
+            depth_nodes.resize(depth + 1);
+        ++depth_nodes[depth];
+        max_depth = std::max(max_depth, depth + 1);
+    }
+
+    SolverStats& operator+=(SolverStats const& other)
+    {
+        decisions += other.decisions;
+        backtracks += other.backtracks;
+        propagations += other.propagations;
+        max_depth = std::max(max_depth, other.max_depth);
+
+        if (depth_nodes.size() < other.depth_nodes.size())
+            depth_nodes.resize(other.depth_nodes.size());
+        for (size_t d = 0; d < other.depth_nodes.size(); ++d)
+            depth_nodes[d] += other.depth_nodes[d];
+
+        setup_ns += other.setup_ns;
+        search_ns += other.search_ns;
+        propagate_ns += other.propagate_ns;
+        return *this;
+    }
+#else
+    SolverStats& operator+=(SolverStats const&) { return *this; }
+#endif
+};
+
+// adds its lifetime to one of the time counters.
+class PhaseTimer
+{
+public:
+    explicit PhaseTimer(int64_t& ns) : ns_(ns), start_(std::chrono::steady_clock::now()) {}
+
+    ~PhaseTimer()
+    {
+        ns_ += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_).count();
+    }
+
+    PhaseTimer(PhaseTimer const&) = delete;
+    PhaseTimer& operator=(PhaseTimer const&) = delete;
+
+private:
+    int64_t& ns_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+#if SUDOKU_STATS
+#define SUDOKU_STAT(statement) statement
+#define SUDOKU_PHASE(counter) PhaseTimer sudoku_phase_timer(counter)
+#else
+#define SUDOKU_STAT(statement) ((void)0)
+#define SUDOKU_PHASE(counter) ((void)0)
+#endif
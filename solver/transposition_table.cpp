@@ -0,0 +1,16 @@
+#include "transposition_table.h"
+
+#include <bit>
+
+TranspositionTable::TranspositionTable(size_t entries)
+    : slots_(new std::atomic<uint64_t>[std::bit_floor(entries | 1)])
+    , mask_(std::bit_floor(entries | 1) - 1)
+{
+    clear();
+}
+
+void TranspositionTable::clear()
+{
+    for (size_t i = 0; i <= mask_; ++i)
+        slots_[i].store(0, std::memory_order_relaxed);
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+// how a search used a table: the counts are kept by each solver, so threads
+// sharing a table do not write to a shared line on every probe.
+struct TableCounters
+{
+    int64_t hits = 0;   // decisions skipped as known dead ends
+    int64_t misses = 0; // decisions looked up and not found
+    int64_t stores = 0; // dead ends recorded
+
+    TableCounters& operator+=(TableCounters const& other)
+    {
+        hits += other.hits;
+        misses += other.misses;
+        stores += other.stores;
+        return *this;
+    }
+};
+
+// Fixed-size table of search states known to have no solution, keyed by the
+// Zobrist hash of their placed values. Whether a set of placed values can be
+// completed does not depend on the puzzle it came from, so one table can be
+// shared by every solve and every thread: entries are single 64-bit words
+// read and written with relaxed atomics, and a lost race only loses an
+// entry. Each hash has one slot and a newer entry replaces an older one.
+class TranspositionTable
+{
+public:
+    // room for `entries` states, rounded down to a power of two, at least 1.
+    explicit TranspositionTable(size_t entries);
+
+    // true when the state with hash `key` is known to be a dead end.
+    bool probe(uint64_t key) const
+    {
+        return slots_[key & mask_].load(std::memory_order_relaxed) == tag(key);
+    }
+
+    void store_dead_end(uint64_t key)
+    {
+        slots_[key & mask_].store(tag(key), std::memory_order_relaxed);
+    }
+
+    void clear();
+
+    size_t size() const { return mask_ + 1; }
+
+private:
+    // zero marks an empty slot, so a hash of zero is kept as one.
+    static uint64_t tag(uint64_t key) { return key | (key == 0); }
+
+    std::unique_ptr<std::atomic<uint64_t>[]> slots_;
+    size_t mask_;
+};
@@ -0,0 +1,143 @@
+#include <catch2/catch.hpp>
+#include "batch.h"
+
+#include <sstream>
+#include <string>
+
+using namespace Catch::Matchers;
+
+TEST_CASE("batch solving", "[batch]")
+{
+    using namespace std::literals;
+
+    const auto easy = "79....3.......69..8...3..76.....5..2..54187..4..7.....61..9...8..23.......9....54"s;
+    const auto easy_solution = "796854321243176985851239476137965842925418763468723519614597238582341697379682154"s;
+    const auto zeros = "000000000000003085001020000000507000004000100090000000500000073002010000000040009"s;
+    const auto zeros_solution = "987654321246173985351928746128537694634892157795461832519286473472319568863745219"s;
+    const auto malformed = "79..x.3.......69..8...3..76.....5..2..54187..4..7.....61..9...8..23.......9....54"s;
+    const auto dots = std::string(81, '.');
+
+    std::stringstream in;
+    in << "# corpus header\n" << easy << "\n\n" << malformed << "\r\n" << zeros << "\n" << easy.substr(0, 40) << "\n" << easy << "  # trailing comment";
+
+    for (Engine engine : {Engine::bitmask, Engine::dlx, Engine::lanes, Engine::bands})
+    {
+        BatchOptions options;
+        options.engine = engine;
+        options.threads = 2;
+
+        std::stringstream data(in.str()), out;
+        const BatchReport report = solve_batch(data, out, options);
+
+        CHECK(report.puzzles == 5);
+        CHECK(report.unsolved == 2);
+        CHECK_THAT(out.str(), Equals(easy_solution + "\n" + dots + "\n" + zeros_solution + "\n" + dots + "\n" + easy_solution + "\n"));
+    }
+
+    SECTION("other formats")
+    {
+        for (OutputFormat format : {OutputFormat::pretty, OutputFormat::binary})
+        {
+            BatchOptions options;
+            options.format = format;
+
+            std::stringstream data(easy + "\n" + malformed + "\n"), out;
+            solve_batch(data, out, options);
+
+            Grid solved, blank;
+            solved.parse(easy_solution);
+
+            std::string expected;
+            format_record(solved, format, expected);
+            format_record(blank, format, expected);
+            CHECK(out.str() == expected);
+        }
+    }
+
+    SECTION("shared transposition table")
+    {
+        // propagation alone does not solve it, so its dead ends are stored.
+        const auto hard = "4.....8.5.3..........7......2.....6.....8.4......1.......6.3.7.5..2.....1.4......"s;
+
+        std::string repeated;
+        for (int i = 0; i < 50; ++i)
+            repeated += hard + "\n";
+
+        TranspositionTable table(1 << 16);
+        BatchOptions options;
+        options.threads = 2;
+        options.bitmask.table = &table;
+
+        std::stringstream out;
+        const BatchReport report = solve_batch(std::string_view(repeated), out, options);
+        CHECK(report.unsolved == 0);
+        CHECK(report.table.misses > 0);
+        CHECK(report.table.hits > 0);
+        CHECK(report.table.stores > 0);
+    }
+
+    SECTION("output keeps input order across slices")
+    {
+        std::string many;
+        for (int i = 0; i < 2000; ++i)
+            many += (i % 3 ? easy : zeros) + "\n";
+
+        BatchOptions options;
+        options.threads = 3;
+
+        std::stringstream out;
+        const BatchReport report = solve_batch(std::string_view(many), out, options);
+        CHECK(report.puzzles == 2000);
+
+        std::string expected;
+        for (int i = 0; i < 2000; ++i)
+            expected += (i % 3 ? easy_solution : zeros_solution) + "\n";
+        CHECK(out.str() == expected);
+    }
+
+    SECTION("workers stay within the output window")
+    {
+        // 30 slices or so against a window of 8, with a slow grid in each.
+        std::string many;
+        std::string expected;
+        for (int i = 0; i < 12000; ++i)
+        {
+            many += (i % 400 ? easy : zeros) + "\n";
+            expected += (i % 400 ? easy_solution : zeros_solution) + "\n";
+        }
+
+        BatchOptions options;
+        options.threads = 4;
+
+        std::stringstream out;
+        const BatchReport report = solve_batch(std::string_view(many), out, options);
+        CHECK(report.puzzles == 12000);
+        CHECK(out.str() == expected);
+    }
+
+    SECTION("limits and cancellation")
+    {
+        BatchOptions options;
+        options.engine = Engine::backtrack;
+        options.max_steps = 1000;
+
+        std::stringstream data(easy + "\n" + malformed + "\n" + zeros + "\n"), out;
+        BatchReport report = solve_batch(data, out, options);
+
+        // the in-order backtracker needs thousands of steps on both grids.
+        CHECK(report.unsolved == 3);
+        CHECK(report.stopped == 2);
+        CHECK(out.str() == dots + "\n" + dots + "\n" + dots + "\n");
+
+        std::stop_source stop;
+        stop.request_stop();
+
+        options.max_steps = 0;
+        options.stop = stop.get_token();
+
+        std::stringstream again(easy + "\n"), cancelled;
+        report = solve_batch(again, cancelled, options);
+        CHECK(report.stopped == 1);
+        CHECK(cancelled.str() == dots + "\n");
+    }
+}
@@ -0,0 +1,117 @@
+#include <catch2/catch.hpp>
+#include "canonical.h"
+#include "bitmask_solver.h"
+#include "test_helpers.h"
+
+#include <string>
+
+namespace
+{
+    // a transformation picked by `seed`, with the rows and columns of
+    // each band and stack and the bands and stacks themselves shuffled.
+    Symmetry make_symmetry(uint32_t seed)
+    {
+        auto next = [&](uint32_t n)
+        {
+            seed = seed * 1664525u + 1013904223u;
+            return (seed >> 16) % n;
+        };
+
+        auto shuffle = [&](auto& values)
+        {
+            for (uint32_t i = uint32_t(values.size()) - 1; i > 0; --i)
+                std::swap(values[i], values[next(i + 1)]);
+        };
+
+        auto lines = [&]
+        {
+            std::array<uint8_t, 3> blocks = {0, 1, 2};
+            shuffle(blocks);
+
+            std::array<uint8_t, 9> order;
+            for (int b = 0; b < 3; ++b)
+            {
+                std::array<uint8_t, 3> within = {0, 1, 2};
+                shuffle(within);
+                for (int i = 0; i < 3; ++i)
+                    order[3 * b + i] = uint8_t(3 * blocks[b] + within[i]);
+            }
+            return order;
+        };
+
+        Symmetry s;
+        s.transpose = next(2) == 1;
+        s.rows = lines();
+        s.cols = lines();
+
+        std::array<uint8_t, 9> digits = {1, 2, 3, 4, 5, 6, 7, 8, 9};
+        shuffle(digits);
+        for (int v = 1; v <= 9; ++v)
+            s.digits[v] = digits[v - 1];
+        return s;
+    }
+}
+
+TEST_CASE("canonical form", "[canonical]")
+{
+    const std::string easy = "79....3.......69..8...3..76.....5..2..54187..4..7.....61..9...8..23.......9....54";
+    const std::string hard = "4.....8.5.3..........7......2.....6.....8.4......1.......6.3.7.5..2.....1.4......";
+    const std::string minimal = "000000010400000000020000000000050407008000300001090000300400200050100000000806000";
+
+    SECTION("symmetries map back")
+    {
+        const Grid puzzle = parse_grid(hard);
+        for (uint32_t seed = 1; seed <= 20; ++seed)
+        {
+            const Symmetry s = make_symmetry(seed);
+            CHECK(to_string(s.inverse().apply(s.apply(puzzle))) == to_string(puzzle));
+            CHECK(s.inverse().inverse() == s);
+        }
+    }
+
+    SECTION("every copy has the same form")
+    {
+        for (auto const& text : {easy, hard, minimal})
+        {
+            const Grid puzzle = parse_grid(text);
+            const CanonicalForm form = canonical_form(puzzle);
+
+            CHECK(to_string(form.symmetry.apply(puzzle)) == to_string(form.grid));
+            CHECK(to_string(canonical_form(form.grid).grid) == to_string(form.grid));
+
+            for (uint32_t seed = 1; seed <= 50; ++seed)
+                CHECK(to_string(canonical_form(make_symmetry(seed).apply(puzzle)).grid) == to_string(form.grid));
+        }
+
+        CHECK(to_string(canonical_form(parse_grid(easy)).grid) != to_string(canonical_form(parse_grid(hard)).grid));
+    }
+
+    SECTION("a solution of the form solves the puzzle")
+    {
+        const Grid puzzle = parse_grid(minimal);
+        const CanonicalForm form = canonical_form(puzzle);
+
+        Grid grid = form.grid;
+        BitmaskSolver solver(grid, {BitmaskSolver::Selection::mrv, true});
+        while (!solver.is_solved())
+            solver.solve_step();
+
+        Grid direct = puzzle;
+        BitmaskSolver check(direct, {BitmaskSolver::Selection::mrv, true});
+        while (!check.is_solved())
+            check.solve_step();
+
+        CHECK(to_string(form.symmetry.inverse().apply(grid)) == to_string(direct));
+    }
+
+    SECTION("sparse grids")
+    {
+        const Grid empty = parse_grid(std::string(81, '.'));
+        CHECK(to_string(canonical_form(empty).grid) == std::string(81, '0'));
+
+        // a single clue ends up last, as a 1.
+        std::string one(81, '.');
+        one[40] = '7';
+        CHECK(to_string(canonical_form(parse_grid(one)).grid) == std::string(80, '0') + "1");
+    }
+}
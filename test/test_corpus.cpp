@@ -0,0 +1,99 @@
+#include <catch2/catch.hpp>
+#include "corpus.h"
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace Catch::Matchers;
+
+namespace
+{
+    std::vector<std::string> records(std::string_view text)
+    {
+        std::vector<std::string> v;
+        for (std::string_view r = next_record(text); !r.empty(); r = next_record(text))
+            v.emplace_back(r);
+        return v;
+    }
+}
+
+TEST_CASE("corpus records", "[corpus]")
+{
+    CHECK(records("").empty());
+    CHECK(records("\n\r\n# only a comment\n").empty());
+    CHECK_THAT(records("a\nb\r\n\n# c\nd # rated 9.1\ne"), Equals(std::vector<std::string>{"a", "b", "d", "e"}));
+}
+
+TEST_CASE("corpus slices", "[corpus]")
+{
+    std::string text = "# header\n";
+    for (int i = 0; i < 100; ++i)
+        text += std::to_string(i) + (i % 7 == 0 ? "\n\n" : "\n");
+
+    for (size_t slice_bytes : {1, 16, 100, 10000})
+    {
+        const CorpusSlices slices(text, slice_bytes);
+        CHECK(slices.size() == (text.size() + slice_bytes - 1) / slice_bytes);
+
+        std::string joined;
+        int64_t records = 0;
+        for (size_t i = 0; i < slices.size(); ++i)
+        {
+            const std::string_view slice = slices[i];
+            CHECK((slice.empty() || slice.ends_with('\n')));
+            CHECK(slice.data() == text.data() + joined.size()); // no copies
+
+            joined += slice;
+            for (std::string_view rest = slice; !next_record(rest).empty();)
+                ++records;
+        }
+
+        CHECK(joined == text);
+        CHECK(records == 100);
+    }
+
+    SECTION("last line without newline")
+    {
+        const CorpusSlices slices("1\n2\n3", 3);
+        REQUIRE(slices.size() == 2);
+        CHECK(slices[0] == "1\n2\n");
+        CHECK(slices[1] == "3");
+    }
+
+    SECTION("lines longer than a slice")
+    {
+        const CorpusSlices slices("123456789\n1\n", 3);
+        REQUIRE(slices.size() == 4);
+        CHECK(slices[0] == "123456789\n");
+        CHECK(slices[1].empty());
+        CHECK(slices[2].empty());
+        CHECK(slices[3] == "1\n");
+    }
+}
+
+TEST_CASE("mapped file", "[corpus]")
+{
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / "sudoku_test_corpus.txt";
+    const std::string content = "12345\n# comment\n67890\n";
+    {
+        std::ofstream file(path, std::ios::binary);
+        file << content;
+    }
+
+    MappedFile file;
+    REQUIRE(file.open(path.string()));
+    CHECK(file.text() == content);
+
+    file.close();
+    CHECK(file.text().empty());
+
+    std::ofstream(path, std::ios::binary | std::ios::trunc).close();
+    CHECK(file.open(path.string()));
+    CHECK(file.text().empty());
+
+    std::filesystem::remove(path);
+    CHECK_FALSE(file.open(path.string()));
+}
@@ -0,0 +1,48 @@
+#include <catch2/catch.hpp>
+#include "generator.h"
+#include "bitmask_solver.h"
+#include "test_helpers.h"
+
+#include <string>
+
+namespace
+{
+    int64_t count_solutions(Grid grid)
+    {
+        BitmaskSolver solver(grid, BitmaskSolver::Options{.selection = BitmaskSolver::Selection::mrv, .propagate = true});
+        return solver.count_solutions(2);
+    }
+}
+
+TEST_CASE("generated puzzles", "[generator]")
+{
+    const std::vector<Grid> puzzles = generate_puzzles(4, GeneratorOptions{.seed = 42, .threads = 2});
+    REQUIRE(puzzles.size() == 4);
+
+    for (Grid const& puzzle : puzzles)
+    {
+        CHECK(count_solutions(puzzle) == 1);
+
+        // every clue is needed.
+        for (int idx = 0; idx < 81; ++idx)
+        {
+            if (puzzle.cells()[idx].val() == 0)
+                continue;
+
+            Grid loose = puzzle;
+            loose.set_given(idx, 0);
+            CHECK(count_solutions(loose) == 2);
+        }
+    }
+
+    SECTION("deterministic per seed")
+    {
+        const std::vector<Grid> again = generate_puzzles(4, GeneratorOptions{.seed = 42, .threads = 1});
+        for (int i = 0; i < 4; ++i)
+            CHECK(to_string(again[i]) == to_string(puzzles[i]));
+
+        CHECK(to_string(generate_puzzle(1)) == to_string(generate_puzzle(1)));
+        CHECK(to_string(generate_puzzle(1)) != to_string(generate_puzzle(2)));
+        CHECK(to_string(puzzles[0]) != to_string(puzzles[1]));
+    }
+}
@@ -0,0 +1,179 @@
+#include <catch2/catch.hpp>
+#include "grid.h"
+
+#include <algorithm>
+#include <array>
+#include <vector>
+
+using namespace Catch::Matchers;
+
+TEST_CASE("topology tables", "[grid]")
+{
+    STATIC_REQUIRE(Topology::units_of[40].row == 4);
+    STATIC_REQUIRE(Topology::units_of[40].col == 4);
+    STATIC_REQUIRE(Topology::units_of[40].box == 4);
+    STATIC_REQUIRE(Topology::units_of[80].box == 8);
+    STATIC_REQUIRE(Topology::cells_of[Topology::box_unit(4)][0] == 30);
+
+    SECTION("every cell belongs to one unit of each kind")
+    {
+        std::array<int, Topology::cell_count> seen{};
+        for (auto const& unit : Topology::cells_of)
+            for (uint8_t idx : unit)
+                ++seen[idx];
+
+        CHECK(std::ranges::all_of(seen, [](int n) { return n == 3; }));
+    }
+
+    SECTION("peers are symmetric and exclude the cell itself")
+    {
+        for (int idx = 0; idx < Topology::cell_count; ++idx)
+        {
+            auto const& peers = Topology::peers[idx];
+            CHECK(std::ranges::find(peers, idx) == peers.end());
+
+            for (uint8_t peer : peers)
+                CHECK(std::ranges::find(Topology::peers[peer], idx) != Topology::peers[peer].end());
+        }
+    }
+}
+
+TEMPLATE_TEST_CASE_SIG("topology of other box sizes", "[grid]", ((int W, int H), W, H), (2, 2), (3, 2), (4, 4), (5, 5))
+{
+    using topology = BasicTopology<W, H>;
+
+    STATIC_REQUIRE(topology::size == W * H);
+    STATIC_REQUIRE(topology::peer_count == 2 * (W * H - 1) + (W - 1) * (H - 1));
+
+    // the last box holds the last cell.
+    STATIC_REQUIRE(topology::units_of[topology::cell_count - 1].box == topology::size - 1);
+    STATIC_REQUIRE(topology::cells_of[topology::box_unit(1)][0] == W);
+    STATIC_REQUIRE(topology::cells_of[topology::box_unit(1)][W] == topology::size + W);
+
+    for (int idx = 0; idx < topology::cell_count; ++idx)
+    {
+        for (auto peer : topology::peers[idx])
+        {
+            const auto a = topology::units_of[idx], b = topology::units_of[peer];
+            CHECK(int(peer) != idx);
+            CHECK((a.row == b.row || a.col == b.col || a.box == b.box));
+        }
+    }
+}
+
+TEST_CASE("digit characters", "[grid]")
+{
+    using Grid16 = BasicGrid<4, 4>;
+
+    STATIC_REQUIRE(Grid16::digit_char(9) == '9');
+    STATIC_REQUIRE(Grid16::digit_char(16) == 'G');
+    STATIC_REQUIRE(Grid16::char_digit('g') == 16);
+    STATIC_REQUIRE(Grid16::char_digit('.') == 0);
+    STATIC_REQUIRE(Grid16::char_digit('H') == -1);
+    STATIC_REQUIRE(Grid::char_digit('A') == -1);
+}
+
+TEST_CASE("grid units", "[grid]")
+{
+    std::array<int, 81> values{};
+    for (int i = 0; i < 81; ++i)
+        values[i] = i % 10;
+
+    Grid grid;
+    grid.init(values);
+
+    auto indexes = [](auto&& unit)
+    {
+        std::vector<int> v;
+        for (Grid::Cell const& c : unit)
+            v.push_back(c.idx_);
+        return v;
+    };
+
+    CHECK_THAT(indexes(grid.row(1)), Equals(std::vector{9, 10, 11, 12, 13, 14, 15, 16, 17}));
+    CHECK_THAT(indexes(grid.col(2)), Equals(std::vector{2, 11, 20, 29, 38, 47, 56, 65, 74}));
+    CHECK_THAT(indexes(grid.zone(8)), Equals(std::vector{60, 61, 62, 69, 70, 71, 78, 79, 80}));
+    CHECK_THAT(indexes(grid.zone_of(grid.cells()[40])), Equals(indexes(grid.zone(4))));
+
+    SECTION("open cells skip the givens")
+    {
+        // every tenth cell is blank, so open.
+        CHECK(grid.next_idx(-1) == 0);
+        CHECK(grid.next_idx(0) == 10);
+        CHECK(grid.next_idx(70) == 80);
+        CHECK(grid.next_idx(80) == -1);
+        CHECK(grid.prev_idx(80) == 70);
+        CHECK(grid.prev_idx(0) == -1);
+
+        grid.set_given(10, 4);
+        CHECK(grid.next_idx(0) == 20);
+        grid.set_given(10, 0);
+        CHECK(grid.next_idx(0) == 10);
+        CHECK(grid.prev_idx(20) == 10);
+    }
+
+    SECTION("copies are independent")
+    {
+        Grid copy = grid;
+        copy.cells()[0].set(5);
+
+        Grid::Cell const& c = *grid.zone(0).begin();
+        CHECK(c.val() == 0);
+    }
+}
+
+TEST_CASE("cell mask", "[grid]")
+{
+    CellMask<81> mask;
+    CHECK(mask.none());
+    CHECK(mask.next(-1) == -1);
+    CHECK(mask.prev(81) == -1);
+
+    for (int idx : {0, 5, 63, 64, 80})
+        mask.set(idx);
+
+    CHECK(mask.count() == 5);
+    CHECK(mask.next(-1) == 0);
+    CHECK(mask.next(5) == 63);
+    CHECK(mask.next(63) == 64);
+    CHECK(mask.next(80) == -1);
+    CHECK(mask.prev(81) == 80);
+    CHECK(mask.prev(64) == 63);
+    CHECK(mask.prev(63) == 5);
+    CHECK(mask.prev(0) == -1);
+
+    mask.reset(64);
+    CHECK(mask.next(63) == 80);
+    CHECK_FALSE(mask.test(64));
+}
+
+TEST_CASE("packed grid", "[grid]")
+{
+    STATIC_REQUIRE(std::is_trivially_copyable_v<PackedGrid>);
+
+    std::array<int, 81> values{};
+    for (int i = 0; i < 81; i += 4)
+        values[i] = 1 + i % 9;
+
+    Grid grid;
+    grid.init(values);
+    grid.cells()[1].set(7); // filled, not a given
+
+    const PackedGrid packed(grid);
+    CHECK(packed.val(1) == 7);
+    CHECK_FALSE(packed.is_given(1));
+    CHECK(packed.is_given(4));
+
+    PackedGrid copy = packed;
+    copy.set(2, 3);
+    CHECK(packed.val(2) == 0);
+
+    Grid restored;
+    packed.unpack(restored);
+    for (int idx = 0; idx < 81; ++idx)
+    {
+        Grid::Cell const& a = grid.cells()[idx];
+        Grid::Cell const& b = restored.cells()[idx];
+        CHECK((a.idx_ == b.idx_ && a.val() == b.val() && a.given() == b.given()));
+    }
+}
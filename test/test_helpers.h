@@ -0,0 +1,34 @@
+#pragma once
+
+#include "grid.h"
+
+#include <array>
+#include <string>
+#include <string_view>
+
+// Helpers shared by the test files, for 9x9 grids written one character per
+// cell with '.' or '0' for blanks.
+
+inline std::array<int, 81> parse(std::string_view text)
+{
+    std::array<int, 81> values{};
+    for (int i = 0; i < 81; ++i)
+        values[i] = Grid::char_digit(text[i]);
+    return values;
+}
+
+inline Grid parse_grid(std::string_view text)
+{
+    Grid grid;
+    grid.parse(text);
+    return grid;
+}
+
+// the values of the cells, '0' for blanks.
+inline std::string to_string(Grid const& grid)
+{
+    std::string s;
+    for (Grid::Cell const& c : grid.cells())
+        s += char('0' + c.val());
+    return s;
+}
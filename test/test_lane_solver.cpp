@@ -0,0 +1,84 @@
+#include <catch2/catch.hpp>
+#include "lane_solver.h"
+#include "bitmask_solver.h"
+#include "test_helpers.h"
+
+#include <algorithm>
+#include <array>
+#include <string>
+#include <string_view>
+#include <vector>
+
+TEST_CASE("lockstep lane solver", "[solver][lanes]")
+{
+    const BitmaskSolver::Options fast{.selection = BitmaskSolver::Selection::mrv, .propagate = true};
+
+    const std::string easy = "79....3.......69..8...3..76.....5..2..54187..4..7.....61..9...8..23.......9....54";
+    const std::string hard = "4.....8.5.3..........7......2.....6.....8.4......1.......6.3.7.5..2.....1.4......";
+    const std::string zeros = "000000000000003085001020000000507000004000100090000000500000073002010000000040009";
+    const std::string loose = ".9....." + easy.substr(7);
+    const std::string repeated = "77" + easy.substr(2);
+    const std::string dead_end = "12345678.........9" + std::string(63, '.');
+
+    // more than one group of lanes, the last one partly filled.
+    std::vector<std::string> puzzles = {easy, hard, zeros, loose, repeated, dead_end};
+    while (puzzles.size() < lane_count + 3)
+        puzzles.push_back(puzzles[puzzles.size() % 4]);
+
+    std::vector<Grid> grids(puzzles.size());
+    for (size_t i = 0; i < puzzles.size(); ++i)
+        grids[i].parse(puzzles[i]);
+
+    SECTION("outcomes of the propagation")
+    {
+        std::vector<Grid> lanes = grids;
+        std::array<LaneOutcome, lane_count> outcomes;
+        propagate_lanes(std::span(lanes).first(lane_count), outcomes);
+
+        CHECK(outcomes[0] == LaneOutcome::solved);
+        CHECK(outcomes[1] == LaneOutcome::needs_search);
+        CHECK(outcomes[3] == LaneOutcome::needs_search);
+        CHECK(outcomes[4] == LaneOutcome::unsolvable);
+        CHECK(outcomes[5] == LaneOutcome::unsolvable);
+
+        // the deduced cells are those the bitmask engine propagates to.
+        for (int i : {1, 2, 3})
+        {
+            Grid scalar = grids[i];
+            BitmaskSolver solver(scalar, fast);
+            CHECK(to_string(lanes[i]) == to_string(scalar));
+        }
+    }
+
+    SECTION("stalled lanes finish with the bitmask engine")
+    {
+        std::vector<Grid> lanes = grids;
+        for (size_t first = 0; first < grids.size(); first += lane_count)
+        {
+            const size_t n = std::min<size_t>(grids.size() - first, lane_count);
+            std::array<LaneOutcome, lane_count> outcomes;
+            propagate_lanes(std::span(lanes).subspan(first, n), outcomes);
+
+            for (size_t i = first; i < first + n; ++i)
+            {
+                bool solved = outcomes[i - first] == LaneOutcome::solved;
+                if (outcomes[i - first] == LaneOutcome::needs_search)
+                {
+                    BitmaskSolver finish(lanes[i], fast);
+                    while (!finish.is_solved() && !finish.is_unsolvable())
+                        finish.solve_step();
+                    solved = finish.is_solved();
+                }
+
+                Grid scalar = grids[i];
+                BitmaskSolver solver(scalar, fast);
+                while (!solver.is_solved() && !solver.is_unsolvable())
+                    solver.solve_step();
+
+                CHECK(solved == solver.is_solved());
+                if (solver.is_solved())
+                    CHECK(to_string(lanes[i]) == to_string(scalar));
+            }
+        }
+    }
+}
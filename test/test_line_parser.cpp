@@ -0,0 +1,90 @@
+#include <catch2/catch.hpp>
+#include "line_parser.h"
+#include "cpu_features.h"
+
+#include <algorithm>
+#include <array>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+    using parse_fn = int (*)(std::string_view, std::span<uint8_t, 81>);
+
+    std::vector<parse_fn> implementations()
+    {
+        std::vector<parse_fn> v = {parse_puzzle_line, parse_puzzle_line_scalar, parse_puzzle_line_sse2};
+        if (cpu_has_avx2())
+            v.push_back(parse_puzzle_line_avx2);
+        return v;
+    }
+}
+
+TEST_CASE("puzzle line parser", "[parser]")
+{
+    const std::string line = "79....3.......69..8...3..76.....5..2..54187..4..7.....61..9...8..23.......9....54";
+
+    std::array<uint8_t, 81> expected{};
+    for (int i = 0; i < 81; ++i)
+        expected[i] = line[i] == '.' ? 0 : uint8_t(line[i] - '0');
+
+    for (parse_fn parse : implementations())
+    {
+        std::array<uint8_t, 81> digits;
+        digits.fill(0xFF);
+        CHECK(parse(line, digits) == -1);
+        CHECK(digits == expected);
+
+        std::string zeros = line;
+        std::ranges::replace(zeros, '.', '0');
+        CHECK(parse(zeros, digits) == -1);
+        CHECK(digits == expected);
+
+        // every position, including the lanes read twice by the vector code.
+        for (int pos = 0; pos < 81; ++pos)
+        {
+            for (char bad : {'/', ':', 'A', ' ', '\0', '\x80'})
+            {
+                std::string malformed = line;
+                malformed[pos] = bad;
+                malformed[80] = (pos < 80) ? 'x' : bad; // a later error is not reported
+                CHECK(parse(malformed, digits) == pos);
+            }
+        }
+    }
+
+    SECTION("wrong lengths")
+    {
+        std::array<uint8_t, 81> digits;
+        CHECK(parse_puzzle_line(line.substr(0, 40), digits) == 40);
+        CHECK(parse_puzzle_line("", digits) == 0);
+        CHECK(parse_puzzle_line(line + "1", digits) == 81);
+        CHECK(parse_puzzle_line("7x" + line, digits) == 1);
+    }
+}
+
+TEST_CASE("vector parsers match the scalar one", "[parser]")
+{
+    std::mt19937 random(7);
+    const std::string alphabet = "0123456789.";
+
+    for (int n = 0; n < 2000; ++n)
+    {
+        std::string line(81, '.');
+        for (char& c : line)
+            c = alphabet[random() % alphabet.size()];
+        if (n % 2)
+            line[random() % 81] = char(random() % 256);
+
+        std::array<uint8_t, 81> reference, digits;
+        const int expected = parse_puzzle_line_scalar(line, reference);
+
+        for (parse_fn parse : implementations())
+        {
+            CHECK(parse(line, digits) == expected);
+            if (expected == -1)
+                CHECK(digits == reference);
+        }
+    }
+}
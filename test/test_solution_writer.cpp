@@ -0,0 +1,100 @@
+#include <catch2/catch.hpp>
+#include "solution_writer.h"
+
+#include <array>
+#include <sstream>
+#include <string>
+
+using namespace Catch::Matchers;
+
+namespace
+{
+    Grid sample()
+    {
+        std::array<int, 81> values{};
+        for (int i = 0; i < 81; ++i)
+            values[i] = (i % 2) ? 0 : 1 + (i / 9 + i) % 9;
+
+        Grid grid;
+        grid.init(values);
+        return grid;
+    }
+}
+
+TEST_CASE("grid formats", "[writer]")
+{
+    const Grid grid = sample();
+
+    SECTION("compact")
+    {
+        std::string out;
+        format_grid(grid, OutputFormat::compact, out);
+        REQUIRE(out.size() == 82);
+        CHECK(out.substr(0, 9) == "1.3.5.7.9");
+        CHECK(out.substr(9, 9) == ".3.5.7.9.");
+        CHECK(out.back() == '\n');
+    }
+
+    SECTION("pretty")
+    {
+        std::string out;
+        format_grid(grid, OutputFormat::pretty, out);
+        CHECK(out.starts_with("-------------------------\n| 1 _ 3 | _ 5 _ | 7 _ 9 |\n| _ 3 _ | 5 _ 7 | _ 9 _ |\n"));
+        CHECK(out.ends_with("|\n-------------------------\n"));
+        CHECK(out.size() == 13 * 26);
+
+        std::string record;
+        format_record(grid, OutputFormat::pretty, record);
+        CHECK(record == out + "\n");
+    }
+
+    SECTION("binary")
+    {
+        std::string out;
+        format_grid(grid, OutputFormat::binary, out);
+        REQUIRE(out.size() == 81);
+        CHECK(out[0] == 1);
+        CHECK(out[1] == 0);
+        CHECK(out[80] == 8);
+    }
+
+    SECTION("other box sizes")
+    {
+        std::array<int, 16> values{};
+        values[0] = 4;
+
+        BasicGrid<2, 2> small;
+        small.init(values);
+
+        std::string out;
+        format_grid(small, OutputFormat::pretty, out);
+        CHECK(out == "-------------\n| 4 _ | _ _ |\n| _ _ | _ _ |\n-------------\n| _ _ | _ _ |\n| _ _ | _ _ |\n-------------\n");
+    }
+}
+
+TEST_CASE("solution writer", "[writer]")
+{
+    const Grid grid = sample();
+    std::string expected;
+    format_record(grid, OutputFormat::compact, expected);
+
+    std::ostringstream out;
+    {
+        SolutionWriter writer(out, OutputFormat::compact);
+        writer.write(grid);
+        CHECK(out.str().empty()); // buffered until flushed
+
+        writer.write_formatted(expected);
+        writer.flush();
+        CHECK(out.str() == expected + expected);
+
+        // enough records to pass the flush size.
+        const int64_t count = SolutionWriter::flush_size / 82 + 10;
+        for (int64_t i = 0; i < count; ++i)
+            writer.write(grid);
+        CHECK(out.str().size() >= SolutionWriter::flush_size);
+    }
+
+    // the rest is written on destruction.
+    CHECK(out.str().size() == (SolutionWriter::flush_size / 82 + 12) * 82);
+}
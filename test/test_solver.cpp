@@ -0,0 +1,766 @@
+#include <catch2/catch.hpp>
+#include "grid.h"
+#include "solver.h"
+#include "bitmask_solver.h"
+#include "dlx_solver.h"
+#include "band_solver.h"
+#include "parallel_solver.h"
+#include "solve_limits.h"
+#include "test_helpers.h"
+
+#include <array>
+#include <numeric>
+#include <string_view>
+#include <type_traits>
+
+namespace
+{
+    bool is_valid_solution(Grid const& grid, std::array<int, 81> const& givens)
+    {
+        auto cells = grid.cells();
+        for (int i = 0; i < 81; ++i)
+        {
+            if (cells[i].val() == 0 || (givens[i] != 0 && cells[i].val() != givens[i]))
+                return false;
+        }
+
+        for (auto const& unit : Topology::cells_of)
+        {
+            int seen = 0;
+            for (uint8_t idx : unit)
+                seen |= 1 << cells[idx].val();
+
+            if (seen != 0x3FE)
+                return false;
+        }
+
+        return true;
+    }
+
+    template <typename S, typename... Args>
+    std::string solve(std::array<int, 81> values, int64_t* steps = nullptr, Args... args)
+    {
+        Grid grid;
+        grid.init(values);
+
+        S solver(grid, args...);
+        while (!solver.is_solved())
+            solver.solve_step();
+
+        if (steps)
+            *steps = solver.solve_steps_;
+
+        CHECK(is_valid_solution(grid, values));
+        return to_string(grid);
+    }
+
+    // solves a grid of any box size and checks every unit holds each digit once.
+    template <typename S, typename... Args>
+    bool solves(std::string_view puzzle, Args... args)
+    {
+        using grid_t = typename S::grid_t;
+        using topology = typename grid_t::topology;
+
+        std::array<int, topology::cell_count> values{};
+        for (int i = 0; i < topology::cell_count; ++i)
+            values[i] = grid_t::char_digit(puzzle[i]);
+
+        grid_t grid;
+        grid.init(values);
+
+        S solver(grid, args...);
+        while (!solver.is_solved() && !solver.is_unsolvable())
+            solver.solve_step();
+
+        auto cells = grid.cells();
+        for (int i = 0; i < topology::cell_count; ++i)
+        {
+            if (values[i] != 0 && cells[i].val() != values[i])
+                return false;
+        }
+
+        for (auto const& unit : topology::cells_of)
+        {
+            uint32_t seen = 0;
+            for (auto idx : unit)
+                seen |= 1u << cells[idx].val();
+
+            if (seen != ((1u << (grid_t::size + 1)) - 2))
+                return false;
+        }
+
+        return solver.is_solved();
+    }
+
+    constexpr std::string_view easy = "79....3.......69..8...3..76.....5..2..54187..4..7.....61..9...8..23.......9....54";
+    constexpr std::string_view medium = "..9748...7.........2.1.9.....7...24..64.1.59..98...3.....8.3.2.........6...2759..";
+    constexpr std::string_view hard = "4.....8.5.3..........7......2.....6.....8.4......1.......6.3.7.5..2.....1.4......";
+}
+
+TEST_CASE("backtracking solver", "[solver]")
+{
+    int64_t steps = 0;
+    solve<Solver>(parse(easy), &steps);
+    CHECK(steps == 8030);
+}
+
+TEST_CASE("bitmask solver matches backtracking solver", "[solver]")
+{
+    auto values = parse(easy);
+
+    int64_t reference_steps = 0, steps = 0;
+    CHECK(solve<BitmaskSolver>(values, &steps) == solve<Solver>(values, &reference_steps));
+    CHECK(steps == reference_steps);
+
+    solve<BitmaskSolver>(parse(medium));
+}
+
+TEST_CASE("bitmask solver with minimum remaining values selection", "[solver]")
+{
+    const BitmaskSolver::Options mrv{.selection = BitmaskSolver::Selection::mrv};
+
+    for (auto puzzle : {easy, medium, hard})
+    {
+        auto values = parse(puzzle);
+
+        int64_t in_order_steps = 0, mrv_steps = 0;
+        const std::string reference = solve<BitmaskSolver>(values, &in_order_steps);
+        CHECK(solve<BitmaskSolver>(values, &mrv_steps, mrv) == reference);
+        CHECK(mrv_steps < in_order_steps);
+    }
+}
+
+TEST_CASE("bitmask solver with constraint propagation", "[solver]")
+{
+    using Selection = BitmaskSolver::Selection;
+
+    for (auto puzzle : {easy, medium, hard})
+    {
+        auto values = parse(puzzle);
+        const std::string reference = solve<BitmaskSolver>(values, nullptr, BitmaskSolver::Options{.selection = Selection::mrv});
+
+        for (Selection selection : {Selection::in_order, Selection::mrv})
+        {
+            const BitmaskSolver::Options options{.selection = selection, .propagate = true};
+            CHECK(solve<BitmaskSolver>(values, nullptr, options) == reference);
+        }
+    }
+
+    SECTION("singles alone solve easy grids")
+    {
+        int64_t steps = -1;
+        solve<BitmaskSolver>(parse(easy), &steps, BitmaskSolver::Options{.propagate = true});
+        CHECK(steps == 0);
+    }
+
+    SECTION("contradictions found by propagation make the grid unsolvable")
+    {
+        // both free cells of the first row need a 9.
+        auto values = parse("1234567.............................................9...........................9");
+
+        Grid grid;
+        grid.init(values);
+
+        BitmaskSolver solver(grid, BitmaskSolver::Options{.propagate = true});
+        CHECK(solver.is_unsolvable());
+    }
+}
+
+TEST_CASE("dancing links solver", "[solver]")
+{
+    const BitmaskSolver::Options fast{.selection = BitmaskSolver::Selection::mrv, .propagate = true};
+
+    for (auto puzzle : {easy, medium, hard})
+    {
+        auto values = parse(puzzle);
+        CHECK(solve<DlxSolver>(values) == solve<BitmaskSolver>(values, nullptr, fast));
+    }
+
+    SECTION("one instance solves several grids")
+    {
+        auto first = parse(hard);
+
+        Grid grid;
+        grid.init(first);
+
+        DlxSolver solver(grid);
+        for (auto puzzle : {easy, medium, hard})
+        {
+            auto values = parse(puzzle);
+            grid.init(values);
+            solver.reset(grid);
+
+            while (!solver.is_solved())
+                solver.solve_step();
+
+            CHECK(is_valid_solution(grid, values));
+        }
+    }
+
+    SECTION("conflicting givens")
+    {
+        auto values = parse(easy);
+        values[2] = 7;
+
+        Grid grid;
+        grid.init(values);
+
+        DlxSolver solver(grid);
+        CHECK(solver.is_unsolvable());
+    }
+}
+
+TEST_CASE("band bitboard solver", "[solver]")
+{
+    const BitmaskSolver::Options fast{.selection = BitmaskSolver::Selection::mrv, .propagate = true};
+
+    for (auto puzzle : {easy, medium, hard})
+    {
+        auto values = parse(puzzle);
+        CHECK(solve<BandSolver>(values) == solve<BitmaskSolver>(values, nullptr, fast));
+    }
+
+    SECTION("one instance solves several grids")
+    {
+        auto first = parse(hard);
+
+        Grid grid;
+        grid.init(first);
+
+        BandSolver solver(grid);
+        for (auto puzzle : {easy, medium, hard})
+        {
+            auto values = parse(puzzle);
+            grid.init(values);
+            solver.reset(grid);
+
+            while (!solver.is_solved())
+                solver.solve_step();
+
+            CHECK(is_valid_solution(grid, values));
+        }
+    }
+
+    SECTION("conflicting givens")
+    {
+        auto values = parse(easy);
+        values[2] = 7;
+
+        Grid grid;
+        grid.init(values);
+
+        BandSolver solver(grid);
+        CHECK(solver.is_unsolvable());
+    }
+
+    SECTION("propagation alone solves the easy grid")
+    {
+        auto values = parse(easy);
+
+        Grid grid;
+        grid.init(values);
+
+        BandSolver solver(grid);
+        CHECK(solver.is_solved());
+        CHECK(solver.solve_steps_ == 0);
+    }
+}
+
+TEMPLATE_TEST_CASE("solvers detect exhausted searches", "[solver]", Solver, BitmaskSolver, DlxSolver, BandSolver)
+{
+    // the first row can not hold a 9 anywhere but on the last cell, which
+    // its column forbids.
+    auto values = parse("12345678.........9...............................................................");
+
+    Grid grid;
+    grid.init(values);
+
+    TestType solver(grid);
+    while (!solver.is_solved() && !solver.is_unsolvable())
+        solver.solve_step();
+
+    CHECK(solver.is_unsolvable());
+}
+
+TEST_CASE("bitmask solver rejects conflicting givens", "[solver]")
+{
+    auto values = parse(easy);
+    values[2] = 7; // 7 is already on the first row
+
+    Grid grid;
+    grid.init(values);
+
+    BitmaskSolver solver(grid);
+    CHECK(solver.is_unsolvable());
+    CHECK_FALSE(solver.is_solved());
+}
+
+TEST_CASE("parallel solver keeps the sequential solution", "[solver][parallel]")
+{
+    const BitmaskSolver::Options mrv{.selection = BitmaskSolver::Selection::mrv, .propagate = true};
+
+    // the last grid has many solutions, only the first in search order is kept.
+    for (auto puzzle : {easy, hard, std::string_view("1........2........3........4........5........6........7........8........9........")})
+    {
+        auto values = parse(puzzle);
+        const std::string reference = solve<BitmaskSolver>(values, nullptr, mrv);
+
+        for (unsigned threads : {1u, 4u})
+        {
+            Grid grid;
+            grid.init(values);
+
+            ParallelSolver solver(grid, ParallelSolver::Options{.bitmask = mrv, .threads = threads, .split_depth = 4});
+            CHECK(solver.solve());
+            CHECK(to_string(grid) == reference);
+        }
+    }
+
+    SECTION("unsolvable grid")
+    {
+        auto values = parse("12345678.........9...............................................................");
+
+        Grid grid;
+        grid.init(values);
+
+        ParallelSolver solver(grid, ParallelSolver::Options{.threads = 2});
+        CHECK_FALSE(solver.solve());
+    }
+}
+
+TEST_CASE("solution counting", "[solver]")
+{
+    const BitmaskSolver::Options fast{.selection = BitmaskSolver::Selection::mrv, .propagate = true};
+
+    auto count = [](std::string_view puzzle, int64_t limit, BitmaskSolver::Options options)
+    {
+        auto values = parse(puzzle);
+
+        Grid grid;
+        grid.init(values);
+
+        BitmaskSolver solver(grid, options);
+        return solver.count_solutions(limit);
+    };
+
+    // the easy grid without its first two givens has 10 solutions.
+    const std::string loose = ".9....." + std::string(easy.substr(7));
+
+    SECTION("counts up to the limit")
+    {
+        for (BitmaskSolver::Options options : {BitmaskSolver::Options{}, fast})
+        {
+            CHECK(count(easy, 10, options) == 1);
+            CHECK(count(loose, 2, options) == 2);
+            CHECK(count(loose, 1000, options) == 10);
+            CHECK(count("12345678.........9...............................................................", 2, options) == 0);
+        }
+
+        CHECK(count(hard, 2, fast) == 1);
+    }
+
+    SECTION("the last solution found stays in the grid")
+    {
+        auto values = parse(hard);
+
+        Grid grid;
+        grid.init(values);
+
+        BitmaskSolver solver(grid, fast);
+        CHECK(solver.count_solutions(1) == 1);
+        CHECK(solver.is_solved());
+        CHECK(is_valid_solution(grid, values));
+    }
+
+    SECTION("exhausting the search restores the grid")
+    {
+        auto values = parse(easy);
+
+        Grid grid;
+        grid.init(values);
+        const std::string initial = to_string(grid);
+
+        BitmaskSolver solver(grid, fast);
+        CHECK(solver.count_solutions(2) == 1);
+        CHECK(solver.is_unsolvable());
+        CHECK(to_string(grid) == initial);
+    }
+
+    SECTION("parallel counting")
+    {
+        auto values = parse(loose);
+
+        Grid grid;
+        grid.init(values);
+        const std::string initial = to_string(grid);
+
+        ParallelSolver solver(grid, ParallelSolver::Options{.threads = 3, .split_depth = 3});
+        CHECK(solver.count_solutions(1000) == 10);
+        CHECK(solver.count_solutions(2) == 2);
+        CHECK(to_string(grid) == initial);
+    }
+
+    SECTION("parallel counting stops at the limit")
+    {
+        // a grid with one row filled has far more solutions than any limit.
+        auto values = parse("123456789" + std::string(72, '.'));
+
+        Grid grid;
+        grid.init(values);
+
+        ParallelSolver solver(grid, ParallelSolver::Options{.threads = 3, .split_depth = 2});
+        CHECK(solver.count_solutions(2) == 2);
+        CHECK(solver.count_solutions(5000) == 5000);
+    }
+}
+
+// ruling out a second solution of the hard grid in order takes the search
+// longer than the rest of the suite, so it only runs when asked for with
+// [slow].
+TEST_CASE("solution counting in order", "[solver][.slow]")
+{
+    auto values = parse(hard);
+
+    Grid grid;
+    grid.init(values);
+
+    BitmaskSolver solver(grid, BitmaskSolver::Options{});
+    CHECK(solver.count_solutions(2) == 1);
+}
+
+TEST_CASE("solvers handle other box sizes", "[solver]")
+{
+    const BitmaskSolver::Options fast{.selection = BitmaskSolver::Selection::mrv, .propagate = true};
+
+    SECTION("4x4")
+    {
+        constexpr std::string_view puzzle = "1...........4..2";
+        CHECK(solves<BasicSolver<2, 2>>(puzzle));
+        CHECK(solves<BasicBitmaskSolver<2, 2>>(puzzle));
+        CHECK(solves<BasicBitmaskSolver<2, 2>>(puzzle, fast));
+    }
+
+    SECTION("6x6 with 3 wide boxes")
+    {
+        constexpr std::string_view puzzle = "......4....3.3..615..2.4.45.12..2...";
+        CHECK(solves<BasicSolver<3, 2>>(puzzle));
+        CHECK(solves<BasicBitmaskSolver<3, 2>>(puzzle, fast));
+    }
+
+    SECTION("16x16")
+    {
+        constexpr std::string_view puzzle =
+            "1.3..67.9A.C.E.G.....A..DE.G....9.B..EFG.2.4.67........4.....A.."
+            "23..6.89A..D.F.1....AB.DEF.12.4..BC.......4.67...FG.2..5.7.9..CD"
+            "..56.89AB.DE.G..78.ABC.EFG.2.45..CDE.G..34...89A.G1234.67...B..E"
+            "....89AB.D.F......A.CD..G..34.6.CD..G....5..89A.G1.34567..A.CDE.";
+        CHECK(solves<BasicBitmaskSolver<4, 4>>(puzzle, fast));
+    }
+
+    SECTION("unsolvable grid")
+    {
+        // the first row needs a 4 where its column already has one.
+        CHECK_FALSE(solves<BasicBitmaskSolver<2, 2>>("123....4........"));
+    }
+}
+
+TEST_CASE("search statistics", "[solver][stats]")
+{
+    const BitmaskSolver::Options fast{.selection = BitmaskSolver::Selection::mrv, .propagate = true};
+
+    auto values = parse(hard);
+
+    Grid grid;
+    grid.init(values);
+
+    BitmaskSolver solver(grid, fast);
+    while (!solver.is_solved())
+        solver.solve_step();
+
+#if !SUDOKU_STATS
+    // nothing is kept, so the engines carry no counters.
+    STATIC_REQUIRE(std::is_empty_v<SolverStats>);
+#else
+    SolverStats const& stats = solver.stats_;
+
+    // every decision still standing is one search step deep.
+    CHECK(stats.decisions - stats.backtracks <= stats.max_depth);
+    CHECK(stats.decisions >= solver.solve_steps_);
+    CHECK(stats.propagations > 0);
+    CHECK(stats.max_depth == (int)stats.depth_nodes.size());
+    CHECK(std::accumulate(stats.depth_nodes.begin(), stats.depth_nodes.end(), int64_t(0)) == stats.decisions);
+    CHECK(stats.search_ns >= stats.propagate_ns - stats.setup_ns);
+
+    SECTION("backtracking and dlx engines")
+    {
+        grid.init(values);
+        Solver backtrack(grid);
+        while (!backtrack.is_solved())
+            backtrack.solve_step();
+
+        // without propagation each step places exactly one decision.
+        CHECK(backtrack.stats_.decisions - backtrack.stats_.backtracks == 81 - 17);
+        CHECK(backtrack.stats_.propagations == 0);
+
+        grid.init(values);
+        DlxSolver dlx(grid);
+        while (!dlx.is_solved())
+            dlx.solve_step();
+
+        CHECK(dlx.stats_.decisions - dlx.stats_.backtracks == 81 - 17);
+        CHECK(dlx.stats_.decisions == dlx.solve_steps_);
+    }
+#endif
+}
+
+TEST_CASE("search events", "[solver][events]")
+{
+    const BitmaskSolver::Options fast{.selection = BitmaskSolver::Selection::mrv, .propagate = true};
+    const std::string loose = ".9....." + std::string(easy.substr(7));
+
+    FrameArena arena;
+
+    SECTION("the first solution matches stepping")
+    {
+        for (BitmaskSolver::Options options : {BitmaskSolver::Options{}, fast})
+        {
+            auto values = parse(hard);
+
+            Grid stepped;
+            stepped.init(values);
+            BitmaskSolver reference(stepped, options);
+            while (!reference.is_solved())
+                reference.solve_step();
+
+            Grid grid;
+            grid.init(values);
+            BitmaskSolver solver(grid, options);
+
+            bool found = false;
+            for (BitmaskSolver::Event const& e : solver.events(arena, BitmaskSolver::Event::solution))
+            {
+                CHECK(e.kind == BitmaskSolver::Event::solution);
+                CHECK(arena.used() > 0);
+                CHECK(solver.is_solved());
+                CHECK(to_string(grid) == to_string(stepped));
+                CHECK(solver.solve_steps_ == reference.solve_steps_);
+                found = true;
+                break;
+            }
+
+            CHECK(found);
+            CHECK(arena.used() == 0);
+        }
+    }
+
+    SECTION("picks up where solve_step left off")
+    {
+        auto values = parse(hard);
+
+        Grid stepped;
+        stepped.init(values);
+        BitmaskSolver reference(stepped, fast);
+        while (!reference.is_solved())
+            reference.solve_step();
+
+        Grid grid;
+        grid.init(values);
+        BitmaskSolver solver(grid, fast);
+        for (int i = 0; i < 5; ++i)
+            solver.solve_step();
+
+        for (BitmaskSolver::Event const& e : solver.events(arena, BitmaskSolver::Event::solution))
+        {
+            CHECK(e.kind == BitmaskSolver::Event::solution);
+            break;
+        }
+
+        CHECK(to_string(grid) == to_string(stepped));
+        CHECK(solver.solve_steps_ == reference.solve_steps_);
+    }
+
+    SECTION("enumeration shares dead ends through the table")
+    {
+        auto values = parse(hard);
+        TranspositionTable table(1 << 14);
+        BitmaskSolver::Options options = fast;
+        options.table = &table;
+
+        Grid grid;
+        grid.init(values);
+        BitmaskSolver solver(grid, options);
+        for ([[maybe_unused]] BitmaskSolver::Event const& e : solver.events(arena, BitmaskSolver::Event::solution))
+        {
+        }
+
+        CHECK(solver.is_unsolvable());
+        CHECK(solver.table_counters_.stores > 0);
+        CHECK(solver.table_counters_.misses > 0);
+
+        // a second enumeration finds the first one's dead ends.
+        grid.init(values);
+        BitmaskSolver again(grid, options);
+        for ([[maybe_unused]] BitmaskSolver::Event const& e : again.events(arena, BitmaskSolver::Event::solution))
+        {
+        }
+
+        CHECK(again.table_counters_.hits > 0);
+        CHECK(again.solve_steps_ < solver.solve_steps_);
+    }
+
+    SECTION("enumerates every solution and restores the grid")
+    {
+        for (BitmaskSolver::Options options : {BitmaskSolver::Options{}, fast})
+        {
+            auto values = parse(loose);
+
+            Grid grid;
+            grid.init(values);
+            const std::string initial = to_string(grid);
+
+            BitmaskSolver solver(grid, options);
+            int solutions = 0;
+            for (BitmaskSolver::Event const& e : solver.events(arena, BitmaskSolver::Event::solution))
+            {
+                CHECK(is_valid_solution(grid, values));
+                solutions += (e.idx == -1);
+            }
+
+            CHECK(solutions == 10);
+            CHECK(solver.is_unsolvable());
+            CHECK(to_string(grid) == initial);
+        }
+    }
+
+    SECTION("placements and removals replay the grid")
+    {
+        auto values = parse(hard);
+
+        Grid grid;
+        grid.init(values);
+
+        BitmaskSolver solver(grid, fast);
+        std::array<int, 81> replay = {};
+        for (int i = 0; i < 81; ++i)
+            replay[i] = grid.cells()[i].val();
+
+        int64_t decisions = 0, forced = 0;
+        for (BitmaskSolver::Event const& e : solver.events(arena))
+        {
+            if (e.kind == BitmaskSolver::Event::solution)
+                break;
+
+            if (e.kind == BitmaskSolver::Event::removed)
+            {
+                CHECK(replay[e.idx] == e.val);
+                replay[e.idx] = 0;
+                continue;
+            }
+
+            CHECK(replay[e.idx] == 0);
+            replay[e.idx] = e.val;
+            decisions += (e.kind == BitmaskSolver::Event::decision);
+            forced += (e.kind == BitmaskSolver::Event::forced);
+        }
+
+        CHECK(decisions > 0);
+        CHECK(forced > 0);
+        for (int i = 0; i < 81; ++i)
+            CHECK(replay[i] == grid.cells()[i].val());
+    }
+}
+
+TEMPLATE_TEST_CASE("solves within limits", "[solver][limits]", Solver, BitmaskSolver, DlxSolver, BandSolver)
+{
+    auto values = parse(hard);
+
+    Grid grid;
+    grid.init(values);
+    TestType solver(grid);
+
+    SECTION("a step budget stops the search where it can resume")
+    {
+        SolveLimits limits;
+        limits.max_steps = 10;
+
+        const SolveResult partial = solve_within(solver, limits);
+        CHECK(partial.status == SolveStatus::budget_spent);
+        CHECK(partial.steps == 10);
+        CHECK_FALSE(solver.is_solved());
+
+        const SolveResult rest = solve_within(solver, SolveLimits{});
+        CHECK(rest.status == SolveStatus::solved);
+        CHECK(is_valid_solution(grid, values));
+    }
+
+    SECTION("a passed deadline")
+    {
+        const SolveResult result = solve_within(solver, SolveLimits::within(std::chrono::nanoseconds(-1)));
+        CHECK(result.status == SolveStatus::timed_out);
+        CHECK(result.steps == 0);
+    }
+
+    SECTION("cancellation")
+    {
+        std::stop_source stop;
+        stop.request_stop();
+
+        SolveLimits limits;
+        limits.stop = stop.get_token();
+        CHECK(solve_within(solver, limits).status == SolveStatus::cancelled);
+    }
+}
+
+TEST_CASE("counting and parallel search within limits", "[solver][limits]")
+{
+    const std::string loose = ".9....." + std::string(easy.substr(7));
+    auto values = parse(loose);
+
+    Grid grid;
+    grid.init(values);
+
+    SECTION("a step budget stops counting where it can resume")
+    {
+        BitmaskSolver solver(grid);
+
+        SolveLimits limits;
+        limits.max_steps = 3;
+        const int64_t first = solver.count_solutions(1000, limits);
+        CHECK(first < 10);
+        CHECK_FALSE(solver.is_unsolvable());
+
+        CHECK(first + solver.count_solutions(1000) == 10);
+        CHECK(solver.is_unsolvable());
+    }
+
+    SECTION("a passed deadline stops the parallel search")
+    {
+        const SolveLimits limits = SolveLimits::within(std::chrono::nanoseconds(-1));
+
+        ParallelSolver solver(grid, ParallelSolver::Options{.threads = 2, .split_depth = 2});
+        CHECK_FALSE(solver.solve(limits));
+        CHECK(solver.status_ == SolveStatus::timed_out);
+
+        CHECK(solver.count_solutions(1000, limits) < 10);
+        CHECK(solver.status_ == SolveStatus::timed_out);
+    }
+
+    SECTION("cancelling the parallel search")
+    {
+        std::stop_source stop;
+        stop.request_stop();
+
+        SolveLimits limits;
+        limits.stop = stop.get_token();
+
+        ParallelSolver solver(grid, ParallelSolver::Options{.threads = 2});
+        CHECK_FALSE(solver.solve(limits));
+        CHECK(solver.status_ == SolveStatus::cancelled);
+
+        // without limits, counting finds them all and solving fills the grid.
+        CHECK(solver.count_solutions(1000) == 10);
+        CHECK(solver.status_ == SolveStatus::unsolvable);
+        CHECK(solver.solve());
+        CHECK(solver.status_ == SolveStatus::solved);
+    }
+}
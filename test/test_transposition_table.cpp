@@ -0,0 +1,150 @@
+#include <catch2/catch.hpp>
+#include "transposition_table.h"
+#include "bitmask_solver.h"
+#include "test_helpers.h"
+
+#include <string>
+
+namespace
+{
+    struct Solve
+    {
+        std::string solution;
+        int64_t steps = 0;
+        bool solved = false;
+        TableCounters table;
+    };
+
+    Solve solve(std::string_view puzzle, BitmaskSolver::Options options)
+    {
+        Grid grid;
+        grid.parse(puzzle);
+
+        BitmaskSolver solver(grid, options);
+        while (!solver.is_solved() && !solver.is_unsolvable())
+            solver.solve_step();
+
+        return {to_string(grid), solver.solve_steps_, solver.is_solved(), solver.table_counters_};
+    }
+}
+
+TEST_CASE("transposition table", "[solver][table]")
+{
+    SECTION("sizes and slots")
+    {
+        CHECK(TranspositionTable(0).size() == 1);
+        CHECK(TranspositionTable(1000).size() == 512);
+
+        TranspositionTable table(1024);
+        CHECK(!table.probe(0x1234));
+
+        table.store_dead_end(0x1234);
+        table.store_dead_end(0);
+        CHECK(table.probe(0x1234));
+        CHECK(table.probe(0));
+        CHECK(!table.probe(0x1234 + 1024)); // same slot, other state
+
+        // a newer state takes the slot over.
+        table.store_dead_end(0x1234 + 1024);
+        CHECK(!table.probe(0x1234));
+
+        table.clear();
+        CHECK(!table.probe(0x1234 + 1024));
+        CHECK(!table.probe(0));
+    }
+
+    const std::string hard = "4.....8.5.3..........7......2.....6.....8.4......1.......6.3.7.5..2.....1.4......";
+    const BitmaskSolver::Options fast{.selection = BitmaskSolver::Selection::mrv, .propagate = true};
+
+    SECTION("the hash follows the grid")
+    {
+        Grid grid;
+        grid.parse(hard);
+
+        BitmaskSolver solver(grid, fast);
+        const uint64_t start = solver.state_hash();
+
+        while (!solver.is_solved())
+            solver.solve_step();
+
+        Grid solved = grid;
+        CHECK(BitmaskSolver(solved).state_hash() == solver.state_hash());
+        CHECK(solver.state_hash() != start);
+
+        // exhausting the search takes every value back off, down to the givens.
+        CHECK(solver.count_solutions(2) == 1);
+
+        Grid givens;
+        givens.parse(hard);
+        CHECK(solver.state_hash() == BitmaskSolver(givens).state_hash());
+    }
+
+    SECTION("dead ends are skipped on the next solve")
+    {
+        TranspositionTable table(1 << 16);
+        BitmaskSolver::Options options = fast;
+        options.table = &table;
+
+        const Solve plain = solve(hard, fast);
+        const Solve first = solve(hard, options);
+        CHECK(first.solution == plain.solution);
+        CHECK(first.steps == plain.steps);
+        CHECK(first.table.hits == 0);
+        CHECK(first.table.misses == first.steps);
+        CHECK(first.table.stores > 0);
+        CHECK(plain.table.misses == 0);
+
+        const Solve again = solve(hard, options);
+        CHECK(again.solution == plain.solution);
+        CHECK(again.steps < first.steps);
+        CHECK(again.table.hits > 0);
+
+        // a wrong value added to the puzzle leaves it without solution, which
+        // takes a search to find the first time.
+        std::string dead_end;
+        Solve dead;
+        for (int idx = 0; idx < 81 && dead.steps < 10; ++idx)
+        {
+            for (char c = '1'; c <= '9' && dead.steps < 10; ++c)
+            {
+                if (hard[idx] != '.' || c == plain.solution[idx])
+                    continue;
+
+                dead_end = hard;
+                dead_end[idx] = c;
+                dead = solve(dead_end, fast);
+            }
+        }
+
+        REQUIRE(!dead.solved);
+        REQUIRE(dead.steps >= 10);
+        // dead ends do not depend on the puzzle, so the ones the hard grid
+        // left may already save steps.
+        const int64_t first_steps = solve(dead_end, options).steps;
+        CHECK(first_steps <= dead.steps);
+        CHECK(solve(dead_end, options).steps < first_steps);
+    }
+
+    SECTION("solutions are never stored as dead ends")
+    {
+        TranspositionTable table(1 << 16);
+        BitmaskSolver::Options options = fast;
+        options.table = &table;
+
+        // the hard grid less a few givens has many solutions.
+        std::string loose = hard;
+        loose[0] = loose[6] = loose[8] = '.';
+
+        auto count = [&](BitmaskSolver::Options o)
+        {
+            Grid grid;
+            grid.parse(loose);
+            return BitmaskSolver(grid, o).count_solutions(1000);
+        };
+
+        const int64_t expected = count(fast);
+        CHECK(expected > 1);
+        CHECK(count(options) == expected);
+        CHECK(count(options) == expected);
+    }
+}